@@ -0,0 +1,161 @@
+﻿#include "CommandBufferBenchmark.h"
+
+#include <span>
+#include <vector>
+
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/EcsCommandBuffer.h"
+#include "Owl/ECS/Prefab.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct VelocityComponent
+	{
+		float X, Y, Z;
+	};
+
+	struct HealthComponent
+	{
+		float Value;
+	};
+
+	template <int N>
+	struct ObserverSystem : System
+	{
+		using System::System;
+	};
+
+	template <int N>
+	void RegisterObserver(World& pWorld, const Signature pSignature)
+	{
+		pWorld.RegisterSystem<ObserverSystem<N>>();
+		pWorld.SetSystemSignature<ObserverSystem<N>>(pSignature);
+	}
+
+	void Setup(World& pWorld, const uint32_t pCount)
+	{
+		pWorld.Initialize(StorageMode::ComponentPools, pCount);
+		pWorld.RegisterComponent<Owl::TransformComponent>();
+		pWorld.RegisterComponent<VelocityComponent>();
+		pWorld.RegisterComponent<HealthComponent>();
+
+		Signature moving;
+		moving.set(pWorld.GetComponentType<Owl::TransformComponent>());
+		moving.set(pWorld.GetComponentType<VelocityComponent>());
+		Signature living = moving;
+		living.set(pWorld.GetComponentType<HealthComponent>());
+
+		RegisterObserver<0>(pWorld, moving);
+		RegisterObserver<1>(pWorld, living);
+		RegisterObserver<2>(pWorld, moving);
+		RegisterObserver<3>(pWorld, living);
+	}
+
+	void SpawnImmediate(World& pWorld, std::vector<Entity>& pEntities)
+	{
+		for (Entity& entity : pEntities)
+		{
+			entity = pWorld.CreateEntity();
+			pWorld.AddComponent(entity, Owl::TransformComponent{});
+			pWorld.AddComponent(entity, VelocityComponent{1.f, 0.f, 0.f});
+			pWorld.AddComponent(entity, HealthComponent{100.f});
+		}
+	}
+
+	void SpawnDeferred(EcsCommandBuffer& pCommands, const uint32_t pCount)
+	{
+		for (uint32_t i = 0; i < pCount; ++i)
+		{
+			const PendingEntity entity = pCommands.CreateEntity();
+			pCommands.AddComponent(entity, Owl::TransformComponent{});
+			pCommands.AddComponent(entity, VelocityComponent{1.f, 0.f, 0.f});
+			pCommands.AddComponent(entity, HealthComponent{100.f});
+		}
+	}
+
+	void DestroyAll(World& pWorld, const std::vector<Entity>& pEntities)
+	{
+		for (const Entity entity : pEntities)
+			pWorld.DestroyEntity(entity);
+	}
+
+	// Each variant spawns one wave to warm up the storage, clears it and times the second wave.
+	void Run(const uint32_t pCount)
+	{
+		std::vector<Entity> entities(pCount);
+
+		double immediate;
+		{
+			World world;
+			Setup(world, pCount);
+			SpawnImmediate(world, entities);
+			DestroyAll(world, entities);
+
+			Owl::Timer timer;
+			SpawnImmediate(world, entities);
+			immediate = timer.Elapsed() * 1e3;
+		}
+
+		double record, playback;
+		{
+			World world;
+			Setup(world, pCount);
+			EcsCommandBuffer commands;
+			SpawnDeferred(commands, pCount);
+			commands.Playback(world);
+			for (uint32_t i = 0; i < pCount; ++i)
+				entities[i] = commands.Resolve(PendingEntity{i});
+			DestroyAll(world, entities);
+
+			Owl::Timer timer;
+			SpawnDeferred(commands, pCount);
+			record = timer.Elapsed() * 1e3;
+
+			timer.Reset();
+			commands.Playback(world);
+			playback = timer.Elapsed() * 1e3;
+		}
+
+		double bulk;
+		{
+			World world;
+			Setup(world, pCount);
+			world.CreateEntities(std::span<Entity>(entities), Owl::TransformComponent{}, VelocityComponent{1.f, 0.f, 0.f}, HealthComponent{100.f});
+			DestroyAll(world, entities);
+
+			Owl::Timer timer;
+			world.CreateEntities(std::span<Entity>(entities), Owl::TransformComponent{}, VelocityComponent{1.f, 0.f, 0.f}, HealthComponent{100.f});
+			bulk = timer.Elapsed() * 1e3;
+		}
+
+		double prefab;
+		{
+			World world;
+			Setup(world, pCount);
+			Prefab projectile(world);
+			projectile.Add(Owl::TransformComponent{}).Add(VelocityComponent{1.f, 0.f, 0.f}).Add(HealthComponent{100.f});
+			world.Instantiate(projectile, std::span<Entity>(entities));
+			DestroyAll(world, entities);
+
+			Owl::Timer timer;
+			world.Instantiate(projectile, std::span<Entity>(entities));
+			prefab = timer.Elapsed() * 1e3;
+		}
+
+		OWL_INFO("[Benchmark] Spawn %8u entities x 3 components: immediate %8.2f ms, command buffer record %8.2f ms + playback %8.2f ms, CreateEntities %8.2f ms, Instantiate %8.2f ms",
+		         pCount, immediate, record, playback, bulk, prefab);
+	}
+}
+
+char CommandBufferBenchmark()
+{
+	for (const uint32_t count : {1000u, 100000u})
+		Run(count);
+
+	return true;
+}
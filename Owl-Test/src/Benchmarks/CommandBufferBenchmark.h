@@ -0,0 +1,8 @@
+﻿#pragma once
+
+/**
+ * \brief Spawns entities through immediate World calls, an EcsCommandBuffer playback, World::CreateEntities
+ * and World::Instantiate of a Prefab.
+ * \return Always true; timings are reported through the log.
+ */
+char CommandBufferBenchmark();
@@ -0,0 +1,173 @@
+﻿#include "ComponentAccessBenchmark.h"
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct VelocityComponent
+	{
+		float X, Y, Z;
+	};
+
+	// The type resolution ComponentManager used before per-type IDs.
+	class NameMapRegistry
+	{
+	public:
+		template <typename T>
+		void Register()
+		{
+			m_ComponentArrays.insert({typeid(T).name(), std::make_shared<ComponentArray<T>>()});
+		}
+
+		template <typename T>
+		std::shared_ptr<ComponentArray<T>> GetComponentArray()
+		{
+			return std::static_pointer_cast<ComponentArray<T>>(m_ComponentArrays[typeid(T).name()]);
+		}
+
+	private:
+		std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_ComponentArrays;
+	};
+
+	// The type resolution of ComponentManager: the process-wide type index, mapped to a type of the registry.
+	class TypeIndexRegistry
+	{
+	public:
+		template <typename T>
+		void Register()
+		{
+			m_ComponentArrays[m_LocalTypes.Assure(ComponentTypeIndex::Get<T>(), "Too many component types.")] = std::make_unique<ComponentArray<T>>();
+		}
+
+		template <typename T>
+		ComponentArray<T>& GetComponentArray()
+		{
+			return static_cast<ComponentArray<T>&>(*m_ComponentArrays[m_LocalTypes.Find(ComponentTypeIndex::Get<T>())]);
+		}
+
+	private:
+		LocalTypeTable<MAX_COMPONENTS> m_LocalTypes;
+		std::array<std::unique_ptr<IComponentArray>, MAX_COMPONENTS> m_ComponentArrays;
+	};
+
+	template <typename T>
+	size_t AddressOf(const std::shared_ptr<T>& pArray) { return reinterpret_cast<size_t>(pArray.get()); }
+
+	template <typename T>
+	size_t AddressOf(const T& pArray) { return reinterpret_cast<size_t>(&pArray); }
+
+	template <typename Registry>
+	double TimeLookups(const uint32_t pCount)
+	{
+		Registry registry;
+		registry.template Register<Owl::TransformComponent>();
+		registry.template Register<VelocityComponent>();
+
+		size_t checksum = 0;
+		Owl::Timer timer;
+		for (uint32_t i = 0; i < pCount; ++i)
+		{
+			auto&& transforms = registry.template GetComponentArray<Owl::TransformComponent>();
+			auto&& velocities = registry.template GetComponentArray<VelocityComponent>();
+			checksum += AddressOf(transforms) ^ AddressOf(velocities);
+		}
+		const double nanoseconds = timer.Elapsed() * 1e9 / (2.0 * pCount);
+
+		if (checksum == 0)
+			OWL_WARN("[Benchmark] Unexpected lookup checksum");
+		return nanoseconds;
+	}
+
+	void RunWorld(const uint32_t pCount)
+	{
+		World world;
+		world.Initialize(StorageMode::ComponentPools, pCount);
+		world.RegisterComponent<Owl::TransformComponent>();
+		world.RegisterComponent<VelocityComponent>();
+
+		std::vector<Entity> entities(pCount);
+		for (Entity& entity : entities)
+			entity = world.CreateEntity();
+
+		Owl::Timer timer;
+		for (const Entity entity : entities)
+		{
+			world.AddComponent(entity, Owl::TransformComponent{});
+			world.AddComponent(entity, VelocityComponent{1.f, 0.f, 0.f});
+		}
+		const double add = timer.Elapsed() * 1e9 / (2.0 * pCount);
+
+		timer.Reset();
+		for (const Entity entity : entities)
+			world.GetComponent<Owl::TransformComponent>(entity).Position.x += world.GetComponent<VelocityComponent>(entity).X;
+		const double get = timer.Elapsed() * 1e9 / (2.0 * pCount);
+
+		timer.Reset();
+		for (const Entity entity : entities)
+		{
+			world.RemoveComponent<VelocityComponent>(entity);
+			world.RemoveComponent<Owl::TransformComponent>(entity);
+		}
+		const double remove = timer.Elapsed() * 1e9 / (2.0 * pCount);
+
+		OWL_INFO("[Benchmark] World %8u entities: AddComponent %7.2f ns/op, GetComponent %7.2f ns/op, RemoveComponent %7.2f ns/op",
+		         pCount, add, get, remove);
+	}
+
+	struct TimeResource
+	{
+		float DeltaTime;
+	};
+
+	// Global data read once per system update: a component on a singleton entity against a world resource.
+	void RunSingleton(const uint32_t pCount)
+	{
+		World world;
+		world.Initialize();
+		world.RegisterComponent<TimeResource>();
+
+		const Entity singleton = world.CreateEntity();
+		world.AddComponent(singleton, TimeResource{0.016f});
+		world.InsertResource(TimeResource{0.016f});
+
+		float sum = 0.f;
+		Owl::Timer timer;
+		for (uint32_t i = 0; i < pCount; ++i)
+			sum += std::as_const(world).GetComponent<TimeResource>(singleton).DeltaTime;
+		const double component = timer.Elapsed() * 1e9 / pCount;
+
+		const ResourceHandle<TimeResource> time = world.GetResourceHandle<TimeResource>();
+		timer.Reset();
+		for (uint32_t i = 0; i < pCount; ++i)
+			sum += time->DeltaTime;
+		const double handle = timer.Elapsed() * 1e9 / pCount;
+
+		if (sum == 0.f)
+			OWL_WARN("[Benchmark] Unexpected singleton checksum");
+		OWL_INFO("[Benchmark] Singleton access: component on entity %6.2f ns/op, resource handle %6.2f ns/op", component, handle);
+	}
+}
+
+char ComponentAccessBenchmark()
+{
+	constexpr uint32_t lookups = 10000000;
+	OWL_INFO("[Benchmark] Component array lookup: typeid name map %6.2f ns/op, type index %6.2f ns/op",
+	         TimeLookups<NameMapRegistry>(lookups), TimeLookups<TypeIndexRegistry>(lookups));
+
+	for (const uint32_t count : {1000u, 100000u})
+		RunWorld(count);
+
+	RunSingleton(lookups);
+
+	return true;
+}
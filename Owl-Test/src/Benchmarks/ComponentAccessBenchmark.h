@@ -0,0 +1,8 @@
+﻿#pragma once
+
+/**
+ * \brief Times World::AddComponent/GetComponent/RemoveComponent, and compares the per-type ID lookup
+ * against the typeid(T).name() map it replaced.
+ * \return Always true; timings are reported through the log.
+ */
+char ComponentAccessBenchmark();
@@ -0,0 +1,327 @@
+﻿#include "EcsBenchmark.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/PoolSorter.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct PositionComponent
+	{
+		float X, Y, Z;
+	};
+
+	struct VelocityComponent
+	{
+		float X, Y, Z;
+	};
+
+	// Registered only to populate the world with pools the benchmarked entities never own.
+	template <int N>
+	struct PaddingComponent
+	{
+		float Value;
+	};
+
+	template <int N>
+	struct FanOutSystem : System
+	{
+		using System::System;
+	};
+
+	constexpr int k_PaddingPools = 24;
+	constexpr int k_FanOutSystems = 16;
+
+	const char* GetModeName(const StorageMode pMode)
+	{
+		return pMode == StorageMode::Archetypes ? "archetypes" : "pools";
+	}
+
+	void Report(const char* pCase, const StorageMode pMode, const uint32_t pCount, const double pSeconds, const double pOperations)
+	{
+		OWL_INFO("[Benchmark] %-24s %-10s %8u entities: %9.2f ns/op, %9.2f Mops/s",
+		         pCase, GetModeName(pMode), pCount, pSeconds * 1e9 / pOperations, pOperations / pSeconds * 1e-6);
+	}
+
+	template <int... Ns>
+	void RegisterPadding(World& pWorld, std::integer_sequence<int, Ns...>)
+	{
+		(pWorld.RegisterComponent<PaddingComponent<Ns>>(), ...);
+	}
+
+	// Every system is indexed under VelocityComponent; every other one also requires PositionComponent,
+	// so toggling VelocityComponent on an entity with a position visits all of them and flips half.
+	template <int... Ns>
+	std::vector<std::shared_ptr<System>> RegisterFanOut(World& pWorld, std::integer_sequence<int, Ns...>)
+	{
+		std::vector<std::shared_ptr<System>> systems;
+		const auto registerSystem = [&pWorld, &systems]<int N>(std::integral_constant<int, N>)
+		{
+			systems.push_back(pWorld.RegisterSystem<FanOutSystem<N>>());
+
+			Signature signature;
+			signature.set(pWorld.GetComponentType<VelocityComponent>());
+			if (N % 2 == 0)
+				signature.set(pWorld.GetComponentType<PositionComponent>());
+			pWorld.SetSystemSignature<FanOutSystem<N>>(signature);
+		};
+		(registerSystem(std::integral_constant<int, Ns>{}), ...);
+		return systems;
+	}
+
+	void Setup(World& pWorld, const StorageMode pMode, const uint32_t pCount)
+	{
+		pWorld.Initialize(pMode, pCount);
+		pWorld.RegisterComponent<PositionComponent>();
+		pWorld.RegisterComponent<VelocityComponent>();
+	}
+
+	void RunChurn(const StorageMode pMode, const uint32_t pCount)
+	{
+		World world;
+		Setup(world, pMode, pCount);
+		std::vector<Entity> entities(pCount);
+
+		// The first wave grows the storage; the second one recycles the freed slots.
+		double create = 0.0, destroy = 0.0;
+		for (int wave = 0; wave < 2; ++wave)
+		{
+			Owl::Timer timer;
+			for (Entity& entity : entities)
+				entity = world.CreateEntity();
+			create = timer.Elapsed();
+
+			timer.Reset();
+			for (const Entity entity : entities)
+				world.DestroyEntity(entity);
+			destroy = timer.Elapsed();
+		}
+
+		Report("CreateEntity (recycled)", pMode, pCount, create, pCount);
+		Report("DestroyEntity (empty)", pMode, pCount, destroy, pCount);
+	}
+
+	void RunAddRemove(const StorageMode pMode, const uint32_t pCount)
+	{
+		World world;
+		Setup(world, pMode, pCount);
+		const std::vector<Entity> entities = world.CreateEntities(pCount, PositionComponent{});
+
+		Owl::Timer timer;
+		for (const Entity entity : entities)
+			world.AddComponent(entity, VelocityComponent{1.f, 0.f, 0.f});
+		const double add = timer.Elapsed();
+
+		timer.Reset();
+		for (const Entity entity : entities)
+			world.RemoveComponent<VelocityComponent>(entity);
+		const double remove = timer.Elapsed();
+
+		Report("AddComponent", pMode, pCount, add, pCount);
+		Report("RemoveComponent", pMode, pCount, remove, pCount);
+	}
+
+	bool RunIteration(const StorageMode pMode, const uint32_t pCount)
+	{
+		World world;
+		Setup(world, pMode, pCount);
+		world.CreateEntities(pCount / 2, PositionComponent{}, VelocityComponent{1.f, 1.f, 1.f});
+		world.CreateEntities(pCount - pCount / 2, PositionComponent{});
+
+		constexpr int passes = 4;
+		uint32_t visited = 0;
+		Owl::Timer timer;
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			world.ForEach<PositionComponent>([&visited](PositionComponent& pPosition)
+			{
+				pPosition.X += 1.f;
+				++visited;
+			});
+		}
+		const double single = timer.Elapsed();
+		ExpectToBeTrue(visited == passes * pCount)
+
+		visited = 0;
+		timer.Reset();
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			world.ForEach<PositionComponent, const VelocityComponent>([&visited](PositionComponent& pPosition, const VelocityComponent& pVelocity)
+			{
+				pPosition.X += pVelocity.X;
+				pPosition.Y += pVelocity.Y;
+				pPosition.Z += pVelocity.Z;
+				++visited;
+			});
+		}
+		const double multi = timer.Elapsed();
+		ExpectToBeTrue(visited == passes * (pCount / 2))
+
+		Report("ForEach<Position>", pMode, pCount, single, static_cast<double>(passes) * pCount);
+		Report("ForEach<Position, Vel>", pMode, pCount, multi, static_cast<double>(passes) * (pCount / 2));
+		if (pMode != StorageMode::ComponentPools)
+			return true;
+
+		const auto group = world.Group<PositionComponent, const VelocityComponent>();
+		visited = 0;
+		timer.Reset();
+		for (int pass = 0; pass < passes; ++pass)
+		{
+			group.Each([&visited](PositionComponent& pPosition, const VelocityComponent& pVelocity)
+			{
+				pPosition.X += pVelocity.X;
+				pPosition.Y += pVelocity.Y;
+				pPosition.Z += pVelocity.Z;
+				++visited;
+			});
+		}
+		const double grouped = timer.Elapsed();
+		ExpectToBeTrue(visited == passes * (pCount / 2))
+
+		Report("Group<Position, Vel>", pMode, pCount, grouped, static_cast<double>(passes) * (pCount / 2));
+		return true;
+	}
+
+	bool RunFanOut(const StorageMode pMode, const uint32_t pCount)
+	{
+		World world;
+		Setup(world, pMode, pCount);
+		const auto systems = RegisterFanOut(world, std::make_integer_sequence<int, k_FanOutSystems>{});
+		const std::vector<Entity> entities = world.CreateEntities(pCount, PositionComponent{});
+
+		Owl::Timer timer;
+		for (const Entity entity : entities)
+			world.AddComponent(entity, VelocityComponent{});
+		const double add = timer.Elapsed();
+		ExpectToBeTrue(systems.back()->GetEntities().Size() == pCount)
+
+		timer.Reset();
+		for (const Entity entity : entities)
+			world.RemoveComponent<VelocityComponent>(entity);
+		const double remove = timer.Elapsed();
+		ExpectToBeTrue(systems.front()->GetEntities().Empty())
+
+		Report("Fan-out add (16 systems)", pMode, pCount, add, pCount);
+		Report("Fan-out remove", pMode, pCount, remove, pCount);
+		return true;
+	}
+
+	// Publishing copies only the slots written since the previous publish.
+	bool RunPublish(const StorageMode pMode, const uint32_t pCount)
+	{
+		if (pMode != StorageMode::ComponentPools)
+			return true;
+
+		World world;
+		Setup(world, pMode, pCount);
+		const std::vector<Entity> entities = world.CreateEntities(pCount, PositionComponent{});
+		world.EnableDoubleBuffering<PositionComponent>();
+
+		for (const uint32_t stride : {1u, 100u})
+		{
+			for (uint32_t i = 0; i < pCount; i += stride)
+				world.GetComponent<PositionComponent>(entities[i]).X = 1.f;
+
+			Owl::Timer timer;
+			world.PublishFrame();
+			const double publish = timer.Elapsed();
+			ExpectToBeTrue(world.GetPreviousComponent<PositionComponent>(entities.front()).X == 1.f)
+
+			Report(stride == 1 ? "Publish (all written)" : "Publish (1% written)", pMode, pCount, publish, pCount);
+		}
+		return true;
+	}
+
+	double TimeIntegrate(World& pWorld, const int pPasses)
+	{
+		Owl::Timer timer;
+		for (int pass = 0; pass < pPasses; ++pass)
+		{
+			pWorld.ForEach<PositionComponent, const VelocityComponent>([](PositionComponent& pPosition, const VelocityComponent& pVelocity)
+			{
+				pPosition.X += pVelocity.X;
+			});
+		}
+		return timer.Elapsed();
+	}
+
+	// Velocities are added in shuffled order, so the two pools are in unrelated orders until sorted by entity.
+	bool RunSort(const StorageMode pMode, const uint32_t pCount)
+	{
+		if (pMode != StorageMode::ComponentPools)
+			return true;
+
+		World world;
+		Setup(world, pMode, pCount);
+		std::vector<Entity> entities = world.CreateEntities(pCount, PositionComponent{});
+		std::shuffle(entities.begin(), entities.end(), std::mt19937(42));
+		for (const Entity entity : entities)
+			world.AddComponent(entity, VelocityComponent{1.f, 0.f, 0.f});
+
+		constexpr int passes = 4;
+		const double shuffled = TimeIntegrate(world, passes);
+
+		PoolSorter sorter = PoolSorter::Create<PositionComponent>(world, [](const Entity pEntity, const PositionComponent&)
+		{
+			return GetEntityIndex(pEntity);
+		});
+		sorter.Mirror<VelocityComponent>(world);
+
+		constexpr float budget = 1.f;
+		uint32_t frames = 1;
+		Owl::Timer timer;
+		while (!sorter.Run(budget))
+			++frames;
+		const double sort = timer.ElapsedMillis();
+
+		const double sorted = TimeIntegrate(world, passes);
+		ExpectToBeTrue(world.GetComponent<VelocityComponent>(entities.front()).X == 1.f)
+
+		Report("Shuffled ForEach<Pos,Vel>", pMode, pCount, shuffled, static_cast<double>(passes) * pCount);
+		Report("Sorted ForEach<Pos,Vel>", pMode, pCount, sorted, static_cast<double>(passes) * pCount);
+		OWL_INFO("[Benchmark] Sorting %u entities by index: %.2f ms over %u frames of %.1f ms", pCount, sort, frames, budget);
+		return true;
+	}
+
+	void RunDestroyWithPools(const StorageMode pMode, const uint32_t pCount)
+	{
+		World world;
+		Setup(world, pMode, pCount);
+		RegisterPadding(world, std::make_integer_sequence<int, k_PaddingPools>{});
+		const std::vector<Entity> entities = world.CreateEntities(pCount, PositionComponent{}, VelocityComponent{});
+
+		Owl::Timer timer;
+		for (const Entity entity : entities)
+			world.DestroyEntity(entity);
+		const double destroy = timer.Elapsed();
+
+		Report("DestroyEntity (26 pools)", pMode, pCount, destroy, pCount);
+	}
+}
+
+char EcsBenchmark()
+{
+	for (const StorageMode mode : {StorageMode::ComponentPools, StorageMode::Archetypes})
+	{
+		for (const uint32_t count : {1000u, 10000u, 100000u, 1000000u})
+		{
+			RunChurn(mode, count);
+			RunAddRemove(mode, count);
+			if (!RunIteration(mode, count) || !RunFanOut(mode, count) || !RunPublish(mode, count) || !RunSort(mode, count))
+				return false;
+			RunDestroyWithPools(mode, count);
+		}
+	}
+
+	return true;
+}
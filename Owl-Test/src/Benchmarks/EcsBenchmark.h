@@ -0,0 +1,10 @@
+﻿#pragma once
+
+/**
+ * \brief ECS microbenchmark suite: create/destroy churn, add/remove component, single and multi component
+ * iteration, system membership fan-out on signature changes and DestroyEntity with many registered pools.
+ * Every case runs from 1k to 1M entities with both storage modes and reports ns/op and throughput, so storage
+ * changes can be compared before and after.
+ * \return False if an iteration visits an unexpected number of entities.
+ */
+char EcsBenchmark();
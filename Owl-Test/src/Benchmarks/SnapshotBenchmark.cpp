@@ -0,0 +1,112 @@
+﻿#include "SnapshotBenchmark.h"
+
+#include <cstdio>
+#include <span>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/WorldSnapshot.h"
+#include "Owl/ECS/WorldStreamer.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct VelocityComponent
+	{
+		float X, Y, Z;
+	};
+
+	void Setup(World& pWorld, const uint32_t pCount)
+	{
+		pWorld.Initialize(StorageMode::ComponentPools, pCount);
+		pWorld.RegisterComponent<Owl::TransformComponent>();
+		pWorld.RegisterComponent<VelocityComponent>();
+	}
+}
+
+char SnapshotBenchmark()
+{
+	constexpr uint32_t count = 1000000;
+	constexpr const char* path = "snapshot-benchmark.owl";
+
+	World source;
+	Setup(source, count);
+
+	std::vector<Entity> entities(count);
+	Owl::Timer timer;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Owl::TransformComponent transform;
+		transform.Position.x = static_cast<float>(i);
+
+		entities[i] = source.CreateEntity();
+		source.AddComponent(entities[i], transform);
+		if (i % 2 == 0)
+			source.AddComponent(entities[i], VelocityComponent{1.f, 0.f, 0.f});
+	}
+	const double build = timer.ElapsedMillis();
+
+	timer.Reset();
+	ExpectToBeTrue(WorldSnapshot::Save(source, path))
+	const double save = timer.ElapsedMillis();
+
+	World loaded;
+	Setup(loaded, count);
+
+	timer.Reset();
+	ExpectToBeTrue(WorldSnapshot::Load(loaded, path))
+	const double load = timer.ElapsedMillis();
+
+	std::remove(path);
+
+	OWL_INFO("[Benchmark] World of %u entities: AddComponent build %8.2f ms, snapshot save %8.2f ms, snapshot load %8.2f ms",
+	         count, build, save, load);
+
+	for (uint32_t i = 0; i < count; i += 997)
+	{
+		ExpectToBeTrue(loaded.IsAlive(entities[i]))
+		ExpectToBeTrue(loaded.GetComponent<Owl::TransformComponent>(entities[i]).Position.x == static_cast<float>(i))
+		ExpectToBeTrue(loaded.HasComponent<VelocityComponent>(entities[i]) == (i % 2 == 0))
+	}
+
+	// Streams the loaded world out and back in cells; only the main thread's share of the work is timed.
+	constexpr uint32_t cellSize = 10000;
+	constexpr uint32_t cellCount = 8;
+	constexpr const char* cellPath = "cell-benchmark-%u.owl";
+	char cellPaths[cellCount][32];
+
+	WorldStreamer streamer(loaded);
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+	{
+		std::snprintf(cellPaths[cell], sizeof(cellPaths[cell]), cellPath, cell);
+		streamer.AddToCell(cell, std::span<const Entity>(entities).subspan(static_cast<size_t>(cell) * cellSize, cellSize));
+	}
+
+	timer.Reset();
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+		streamer.UnloadCell(cell, cellPaths[cell]);
+	const double unload = timer.ElapsedMillis() / cellCount;
+
+	for (uint32_t cell = 0; cell < cellCount; ++cell)
+		streamer.RequestLoad(cell, cellPaths[cell]);
+	streamer.Wait();
+
+	timer.Reset();
+	const uint32_t spliced = streamer.SpliceLoadedCells(cellCount);
+	const double splice = timer.ElapsedMillis() / cellCount;
+	ExpectToBeTrue(spliced == cellCount)
+	ExpectToBeTrue(loaded.GetComponent<Owl::TransformComponent>(streamer.GetEntities(0).front()).Position.x < static_cast<float>(cellSize))
+
+	for (const char* cellFile : cellPaths)
+		std::remove(cellFile);
+
+	OWL_INFO("[Benchmark] Cells of %u entities, main thread share: unload %7.2f ms, splice %7.2f ms",
+	         cellSize, unload, splice);
+
+	return true;
+}
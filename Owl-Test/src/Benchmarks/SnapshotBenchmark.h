@@ -0,0 +1,8 @@
+﻿#pragma once
+
+/**
+ * \brief Saves and loads a World of 1M entities through WorldSnapshot, against rebuilding it with AddComponent,
+ * and checks the loaded world matches the saved one.
+ * \return False if the snapshot round trip fails.
+ */
+char SnapshotBenchmark();
@@ -0,0 +1,97 @@
+﻿#include "SparseSetBenchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/SparseSet.h"
+
+namespace
+{
+	using Owl::Ecs::Entity;
+
+	// The entity/index bookkeeping ComponentArray used before the sparse set.
+	class MapEntityIndex
+	{
+	public:
+		size_t Insert(const Entity pEntity)
+		{
+			const size_t index = m_Size++;
+			m_EntityToIndexMap[pEntity] = index;
+			m_IndexToEntityMap[index] = pEntity;
+			return index;
+		}
+
+		void Remove(const Entity pEntity)
+		{
+			const size_t indexOfRemovedEntity = m_EntityToIndexMap[pEntity];
+			const size_t indexOfLastElement = m_Size - 1;
+			const Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
+
+			m_EntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
+			m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+
+			m_EntityToIndexMap.erase(pEntity);
+			m_IndexToEntityMap.erase(indexOfLastElement);
+
+			--m_Size;
+		}
+
+		size_t IndexOf(const Entity pEntity)
+		{
+			return m_EntityToIndexMap[pEntity];
+		}
+
+	private:
+		std::unordered_map<Entity, size_t> m_EntityToIndexMap;
+		std::unordered_map<size_t, Entity> m_IndexToEntityMap;
+		size_t m_Size = 0;
+	};
+
+	template <typename Index>
+	void Run(const char* pName, const std::vector<Entity>& pEntities)
+	{
+		Index index;
+		const double count = static_cast<double>(pEntities.size());
+
+		Owl::Timer timer;
+		for (const Entity entity : pEntities)
+			index.Insert(entity);
+		const double insert = timer.Elapsed() * 1e9 / count;
+
+		size_t checksum = 0;
+		timer.Reset();
+		for (const Entity entity : pEntities)
+			checksum += index.IndexOf(entity);
+		const double lookup = timer.Elapsed() * 1e9 / count;
+
+		timer.Reset();
+		for (const Entity entity : pEntities)
+			index.Remove(entity);
+		const double remove = timer.Elapsed() * 1e9 / count;
+
+		OWL_INFO("[Benchmark] %-14s %8zu entities: insert %7.2f ns/op, lookup %7.2f ns/op, remove %7.2f ns/op (checksum %zu)",
+		         pName, pEntities.size(), insert, lookup, remove, checksum);
+	}
+}
+
+char SparseSetBenchmark()
+{
+	std::mt19937 random(42);
+
+	for (const size_t count : {1000u, 100000u, 1000000u})
+	{
+		std::vector<Entity> entities(count);
+		for (size_t i = 0; i < count; ++i)
+			entities[i] = static_cast<Entity>(i);
+		std::ranges::shuffle(entities, random);
+
+		Run<MapEntityIndex>("unordered_map", entities);
+		Run<Owl::Ecs::SparseSet>("SparseSet", entities);
+	}
+
+	return true;
+}
@@ -0,0 +1,7 @@
+﻿#pragma once
+
+/**
+ * \brief Compares Ecs::SparseSet against the unordered_map entity index it replaced, at 1k, 100k and 1M entities.
+ * \return Always true; timings are reported through the log.
+ */
+char SparseSetBenchmark();
@@ -0,0 +1,91 @@
+﻿#include "SpatialIndexBenchmark.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+#include "Owl/ECS/Systems/SpatialIndex.h"
+
+char SpatialIndexBenchmark()
+{
+	using namespace Owl::Ecs;
+
+	constexpr uint32_t count = 100000;
+	constexpr uint32_t queries = 1000;
+	constexpr float extent = 500.f;
+	constexpr float radius = 10.f;
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> coordinate(-extent, extent);
+	const auto randomPoint = [&] { return Owl::Vector3(coordinate(random), coordinate(random), coordinate(random)); };
+
+	World world;
+	world.Initialize(StorageMode::ComponentPools, count);
+	world.RegisterComponent<Owl::TransformComponent>();
+
+	std::vector<Entity> entities(count);
+	for (Entity& entity : entities)
+	{
+		Owl::TransformComponent transform;
+		transform.Position = randomPoint();
+		entity = world.CreateEntity();
+		world.AddComponent(entity, transform);
+	}
+
+	Owl::Timer timer;
+	const SpatialIndex& index = world.EmplaceResource<SpatialIndex>(world, radius);
+	const double build = timer.ElapsedMillis();
+
+	std::vector<Owl::Vector3> centers(queries);
+	for (Owl::Vector3& center : centers)
+		center = randomPoint();
+
+	size_t scanned = 0;
+	timer.Reset();
+	for (const Owl::Vector3& center : centers)
+	{
+		world.View<const Owl::TransformComponent>().Each([&](const Owl::TransformComponent& pTransform)
+		{
+			scanned += (pTransform.Position - center).LenghtSquared() <= radius * radius;
+		});
+	}
+	const double scan = timer.Elapsed() * 1e6 / queries;
+
+	size_t found = 0;
+	timer.Reset();
+	for (const Owl::Vector3& center : centers)
+		index.QueryRadius(center, radius, [&found](Entity, const Owl::Vector3&) { ++found; });
+	const double grid = timer.Elapsed() * 1e6 / queries;
+	ExpectToBeTrue(found == scanned)
+
+	std::vector<Entity> nearest;
+	timer.Reset();
+	for (const Owl::Vector3& center : centers)
+		index.QueryNearest(center, 16, nearest);
+	const double knn = timer.Elapsed() * 1e6 / queries;
+
+	RaycastHit hit;
+	uint32_t hits = 0;
+	timer.Reset();
+	for (const Owl::Vector3& center : centers)
+		hits += index.Raycast(center, randomPoint() - center, extent, 2.f, hit);
+	const double ray = timer.Elapsed() * 1e6 / queries;
+
+	for (uint32_t i = 0; i < count; i += 10)
+		world.GetComponent<Owl::TransformComponent>(entities[i]).Position += Owl::Vector3(1.f, 0.f, 0.f);
+	timer.Reset();
+	world.FlushObservers();
+	const double update = timer.ElapsedMillis();
+
+	OWL_INFO("[Benchmark] Spatial index over %u entities: build %7.2f ms, update after %u moves %7.2f ms",
+	         count, build, count / 10, update);
+	OWL_INFO("[Benchmark] Radius %.0f query: full scan %9.2f us, grid %7.2f us; 16 nearest %7.2f us; raycast %7.2f us (%u hits)",
+	         radius, scan, grid, knn, ray, hits);
+
+	return true;
+}
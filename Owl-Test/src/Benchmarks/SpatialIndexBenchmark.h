@@ -0,0 +1,8 @@
+﻿#pragma once
+
+/**
+ * \brief Compares radius queries through SpatialIndex against scanning every TransformComponent, times nearest
+ * and ray queries, and the incremental update after a tenth of the entities moved.
+ * \return False if the grid and the scan disagree.
+ */
+char SpatialIndexBenchmark();
@@ -0,0 +1,67 @@
+﻿#include "TransformBatchBenchmark.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/Timer.h"
+#include "Owl/ECS/Systems/TransformBatch.h"
+
+namespace
+{
+	using namespace Owl;
+	using InstructionSet = Ecs::TransformBatch::InstructionSet;
+
+	float MaxError(const std::vector<Matrix4>& pExpected, const std::vector<Matrix4>& pActual)
+	{
+		float error = 0.f;
+		for (size_t i = 0; i < pExpected.size(); ++i)
+		{
+			for (size_t j = 0; j < 16; ++j)
+				error = std::max(error, Math::Abs(pExpected[i].Data[j] - pActual[i].Data[j]));
+		}
+		return error;
+	}
+}
+
+char TransformBatchBenchmark()
+{
+	constexpr uint32_t count = 100000;
+	constexpr int repeats = 10;
+
+	// Angles of up to two turns either way, so every quadrant of the vector sine/cosine is exercised.
+	std::vector<TransformComponent> transforms(count);
+	for (TransformComponent& transform : transforms)
+	{
+		transform.Position = {Math::RandomRangeFloat(-100.f, 100.f), Math::RandomRangeFloat(-100.f, 100.f), Math::RandomRangeFloat(-100.f, 100.f)};
+		transform.Scale = {Math::RandomRangeFloat(0.1f, 4.f), Math::RandomRangeFloat(0.1f, 4.f), Math::RandomRangeFloat(0.1f, 4.f)};
+		transform.Rotation = {Math::RandomRangeFloat(-12.5f, 12.5f), Math::RandomRangeFloat(-12.5f, 12.5f), Math::RandomRangeFloat(-12.5f, 12.5f)};
+	}
+
+	std::vector<Matrix4> reference(count);
+	std::vector<Matrix4> matrices(count);
+	Ecs::TransformBatch::ComputeLocalMatrices(transforms, reference, InstructionSet::Scalar);
+
+	for (const InstructionSet instructionSet : {InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2})
+	{
+		if (instructionSet > Ecs::TransformBatch::GetSupportedInstructionSet())
+			continue;
+
+		double best = 0.0;
+		for (int i = 0; i < repeats; ++i)
+		{
+			Timer timer;
+			Ecs::TransformBatch::ComputeLocalMatrices(transforms, matrices, instructionSet);
+			const double elapsed = timer.ElapsedMillis();
+			best = i == 0 ? elapsed : std::min(best, elapsed);
+		}
+
+		const float error = MaxError(reference, matrices);
+		OWL_INFO("[Benchmark] Local matrices for %u transforms, %-6s: %7.3f ms, max error %g",
+		         count, Ecs::TransformBatch::GetName(instructionSet), best, error);
+		ExpectToBeTrue(error < 1e-4f)
+	}
+
+	return true;
+}
@@ -0,0 +1,8 @@
+﻿#pragma once
+
+/**
+ * \brief Times TransformBatch on every instruction set the CPU supports against the scalar
+ * TransformComponent::GetLocalMatrix reference, and checks the vector results match it.
+ * \return False if a vector path drifts from the reference.
+ */
+char TransformBatchBenchmark();
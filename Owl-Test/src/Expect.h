@@ -3,31 +3,31 @@
 #include "Owl/Math/Math.h"
 
 #define ExpectShouldBe(expected, actual)                                                                \
-	if (actual != expected) {																			\
+	if ((actual) != (expected)) {																			\
 		OWL_ERROR("--> Expected  %lld, but got  %lld. File %s, ligne %d", expected, actual, __FILE__, __LINE__); \
 		return false;																					\
 	}																									\
 
 #define ExpectShouldNotBe(expected, actual)																				\
-	if (actual == expected) {																							\
+	if ((actual) == (expected)) {																							\
 		OWL_ERROR("--> Expected %lld != %lld, but they are equal. File %s, ligne %d", expected, actual, __FILE__, __LINE__);	\
 		return false;																									\
 	}																													\
 
 #define ExpectFloatShouldBe(expected, actual)                                                           \
-	if (Math::Abs(expected - actual) > 0.001f) {															\
+	if (Math::Abs((expected) - (actual)) > 0.001f) {															\
 		OWL_ERROR("--> Expected %lld, but got %lld. File %s, ligne %d", expected, actual, __FILE__, __LINE__); \
 		return false;																					\
 	}																									\
 
 #define ExpectToBeTrue(actual)                                                          \
-	if (actual != true) {																\
+	if ((actual) != true) {																\
 		OWL_ERROR("--> Expected true but got false. File %s, ligne %d", __FILE__, __LINE__); \
 		return false;																	\
 	}																					\
 
 #define ExpectToBeFalse(actual)                                                         \
-	if (actual != false) {																\
+	if ((actual) != false) {																\
 		OWL_ERROR("--> Expected false but got true. File %s, ligne %d", __FILE__, __LINE__); \
 		return false;																	\
 	}	
@@ -1,12 +1,50 @@
 ﻿#include "TestManager.h"
+#include "Benchmarks/CommandBufferBenchmark.h"
+#include "Benchmarks/ComponentAccessBenchmark.h"
+#include "Benchmarks/EcsBenchmark.h"
+#include "Benchmarks/SnapshotBenchmark.h"
+#include "Benchmarks/SpatialIndexBenchmark.h"
+#include "Benchmarks/SparseSetBenchmark.h"
+#include "Benchmarks/TransformBatchBenchmark.h"
+#include "Tests/CommandBufferTest.h"
+#include "Tests/DoubleBufferTest.h"
+#include "Tests/GroupTest.h"
+#include "Tests/ObserverTest.h"
+#include "Tests/PoolSorterTest.h"
+#include "Tests/PrefabTest.h"
+#include "Tests/SpatialIndexTest.h"
+#include "Tests/TagComponentTest.h"
+#include "Tests/TransformSystemTest.h"
+#include "Tests/WorldStreamerTest.h"
 #include "Owl/Debug/Log.h"
 
 int main()
 {
-	uint64_t logSize;
-	Owl::Log::Initialize(&logSize, nullptr);
+	Owl::Log::Initialize();
 	auto testManager = TestManager();
 
+	testManager.RegisterTest(TransformSystemDestroyedChildTest, "TransformSystem drops destroyed children");
+	testManager.RegisterTest(TransformSystemDestroyedParentTest, "TransformSystem turns children of a destroyed parent into roots");
+	testManager.RegisterTest(CommandBufferDoubleDestroyTest, "EcsCommandBuffer drops commands for entities destroyed by another buffer");
+	testManager.RegisterTest(SpatialIndexNearestTest, "SpatialIndex nearest query matches a full scan");
+	testManager.RegisterTest(SpatialIndexRaycastTest, "SpatialIndex raycast matches a full scan");
+	testManager.RegisterTest(SpatialIndexRadiusTest, "SpatialIndex radius query matches a full scan");
+	testManager.RegisterTest(DoubleBufferLagTest, "Published components lag exactly one PublishFrame");
+	testManager.RegisterTest(GroupMembershipTest, "Groups track membership through add, remove and destroy");
+	testManager.RegisterTest(ObserverCancellationTest, "Observers only see the net effect of a batch");
+	testManager.RegisterTest(ObserverSetAfterAddTest, "Observers do not report added components as set");
+	testManager.RegisterTest(PoolSorterMirrorTest, "PoolSorter sorts a pool and its mirror in the same order");
+	testManager.RegisterTest(PoolSorterGroupTest, "PoolSorter sorts a group in lockstep");
+	testManager.RegisterTest(PrefabInstantiateTest, "Instantiate copies every prefab component");
+	testManager.RegisterTest(TagComponentViewTest, "Views filter on tags and systems iterate a tag alone");
+	testManager.RegisterTest(WorldStreamerRoundTripTest, "WorldStreamer remaps entity fields across an unload and load");
+	testManager.RegisterTest(SparseSetBenchmark, "SparseSet vs unordered_map entity index benchmark");
+	testManager.RegisterTest(ComponentAccessBenchmark, "World component access benchmark");
+	testManager.RegisterTest(CommandBufferBenchmark, "Entity spawn benchmark");
+	testManager.RegisterTest(TransformBatchBenchmark, "Transform batch benchmark");
+	testManager.RegisterTest(SnapshotBenchmark, "World snapshot benchmark");
+	testManager.RegisterTest(EcsBenchmark, "ECS microbenchmark suite");
+	testManager.RegisterTest(SpatialIndexBenchmark, "Spatial index benchmark");
 
 	testManager.RunTests();
 
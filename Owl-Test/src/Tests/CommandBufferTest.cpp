@@ -0,0 +1,55 @@
+﻿#include "CommandBufferTest.h"
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/EcsCommandBuffer.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct HealthComponent
+	{
+		float Value;
+	};
+}
+
+char CommandBufferDoubleDestroyTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<HealthComponent>();
+
+	const Entity target = world.CreateEntity();
+	world.AddComponent(target, HealthComponent{1.f});
+	const Entity other = world.CreateEntity();
+
+	EcsCommandBuffer first;
+	EcsCommandBuffer second;
+	first.DestroyEntity(target);
+	second.DestroyEntity(target);
+	second.AddComponent(other, HealthComponent{2.f});
+
+	EcsCommandBuffer late;
+	late.AddComponent(target, HealthComponent{3.f});
+	late.RemoveComponent<HealthComponent>(target);
+
+	first.Playback(world);
+	second.Playback(world);
+	late.Playback(world);
+
+	const World& view = world;
+	ExpectToBeFalse(view.IsAlive(target))
+	ExpectToBeTrue((view.GetComponent<HealthComponent>(other).Value == 2.f))
+
+	// The slot was freed once, so the next two entities get distinct slots.
+	const Entity reused = world.CreateEntity();
+	const Entity fresh = world.CreateEntity();
+	ExpectToBeTrue((GetEntityIndex(reused) != GetEntityIndex(fresh)))
+	ExpectToBeTrue(view.IsAlive(reused))
+	ExpectToBeTrue(view.IsAlive(fresh))
+	ExpectToBeTrue(view.IsAlive(other))
+
+	return true;
+}
@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Plays back two buffers destroying the same entity: the second must drop its commands, not free the slot again.
+ */
+char CommandBufferDoubleDestroyTest();
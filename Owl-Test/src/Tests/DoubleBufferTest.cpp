@@ -0,0 +1,71 @@
+﻿#include "DoubleBufferTest.h"
+
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct PositionComponent
+	{
+		float Value;
+	};
+}
+
+char DoubleBufferLagTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<PositionComponent>();
+
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const Entity entity = world.CreateEntity();
+		world.AddComponent(entity, PositionComponent{0.f});
+		entities.push_back(entity);
+	}
+	world.EnableDoubleBuffering<PositionComponent>();
+
+	// What the last PublishFrame copied, and what was written since.
+	std::vector<float> published(entities.size(), 0.f);
+	std::vector<float> current(entities.size(), 0.f);
+
+	for (uint32_t frame = 1; frame <= 4; ++frame)
+	{
+		// Only half the entities move after the first frame, so unchanged slots must keep their published value too.
+		size_t moved = 0;
+		for (size_t i = 0; i < entities.size(); ++i)
+		{
+			if (frame > 1 && i % 2 != 0)
+				continue;
+
+			current[i] = static_cast<float>(frame);
+			world.GetComponent<PositionComponent>(entities[i]).Value = current[i];
+			++moved;
+		}
+
+		// Until the frame is published, readers still see the previous one.
+		for (size_t i = 0; i < entities.size(); ++i)
+			ExpectToBeTrue((world.GetPreviousComponent<PositionComponent>(entities[i]).Value == published[i]))
+
+		size_t lagging = 0;
+		world.View<const PositionComponent, Previous<PositionComponent>>().Each(
+			[&lagging](const PositionComponent& pCurrent, const PositionComponent& pPublished)
+			{
+				lagging += pCurrent.Value != pPublished.Value;
+			});
+		ExpectToBeTrue((lagging == moved))
+
+		world.PublishFrame();
+		published = current;
+		for (size_t i = 0; i < entities.size(); ++i)
+			ExpectToBeTrue((world.GetPreviousComponent<PositionComponent>(entities[i]).Value == published[i]))
+	}
+
+	return true;
+}
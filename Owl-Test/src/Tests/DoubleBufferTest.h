@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Writes a double-buffered component every frame and checks the published copy lags exactly one PublishFrame.
+ */
+char DoubleBufferLagTest();
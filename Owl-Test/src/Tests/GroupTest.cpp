@@ -0,0 +1,82 @@
+﻿#include "GroupTest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/Group.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct PositionComponent
+	{
+		float Value;
+	};
+
+	struct VelocityComponent
+	{
+		float Value;
+	};
+
+	bool Contains(const Group<PositionComponent, VelocityComponent>& pGroup, const Entity pEntity)
+	{
+		const auto entities = pGroup.GetEntities();
+		return std::find(entities.begin(), entities.end(), pEntity) != entities.end();
+	}
+}
+
+char GroupMembershipTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<PositionComponent>();
+	world.RegisterComponent<VelocityComponent>();
+
+	// Entities owning both pools before the group exists are packed when it is created.
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 8; ++i)
+	{
+		const Entity entity = world.CreateEntity();
+		world.AddComponent(entity, PositionComponent{static_cast<float>(i)});
+		if (i % 2 == 0)
+			world.AddComponent(entity, VelocityComponent{static_cast<float>(i)});
+		entities.push_back(entity);
+	}
+
+	const Group<PositionComponent, VelocityComponent> group = world.Group<PositionComponent, VelocityComponent>();
+	ExpectToBeTrue((group.Size() == 4))
+
+	world.AddComponent(entities[1], VelocityComponent{1.f});
+	ExpectToBeTrue((group.Size() == 5))
+	ExpectToBeTrue(Contains(group, entities[1]))
+
+	world.RemoveComponent<PositionComponent>(entities[2]);
+	ExpectToBeTrue((group.Size() == 4))
+	ExpectToBeTrue(!Contains(group, entities[2]))
+
+	world.DestroyEntity(entities[4]);
+	ExpectToBeTrue((group.Size() == 3))
+	ExpectToBeTrue(!Contains(group, entities[4]))
+
+	// Destroying an entity outside the group leaves it untouched.
+	world.DestroyEntity(entities[3]);
+	ExpectToBeTrue((group.Size() == 3))
+
+	// The packed slots hold the members with their own components.
+	size_t matching = 0;
+	group.Each([&](const Entity pEntity, const PositionComponent& pPosition, const VelocityComponent& pVelocity)
+	{
+		matching += pPosition.Value == pVelocity.Value && world.HasComponent<PositionComponent>(pEntity) &&
+			world.HasComponent<VelocityComponent>(pEntity);
+	});
+	ExpectToBeTrue((matching == 3))
+	ExpectToBeTrue(Contains(group, entities[0]))
+	ExpectToBeTrue(Contains(group, entities[1]))
+	ExpectToBeTrue(Contains(group, entities[6]))
+
+	return true;
+}
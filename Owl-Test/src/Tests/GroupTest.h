@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Adds, removes and destroys around an owned group and checks it holds exactly the entities owning all its pools.
+ */
+char GroupMembershipTest();
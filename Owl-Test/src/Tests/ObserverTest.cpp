@@ -0,0 +1,116 @@
+﻿#include "ObserverTest.h"
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct HealthComponent
+	{
+		float Value;
+	};
+
+	struct Recorder
+	{
+		std::vector<Entity> Entities;
+
+		ObserverCallback Callback()
+		{
+			return [this](const std::span<const Entity> pEntities) { Entities.insert(Entities.end(), pEntities.begin(), pEntities.end()); };
+		}
+
+		[[nodiscard]] bool Saw(const Entity pEntity) const
+		{
+			return std::find(Entities.begin(), Entities.end(), pEntity) != Entities.end();
+		}
+	};
+}
+
+char ObserverCancellationTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<HealthComponent>();
+
+	Recorder added;
+	Recorder removed;
+	world.Observe<HealthComponent>(ComponentEvent::Added, added.Callback());
+	world.Observe<HealthComponent>(ComponentEvent::Removed, removed.Callback());
+
+	const Entity existing = world.CreateEntity();
+	world.AddComponent(existing, HealthComponent{1.f});
+	world.FlushObservers();
+	added.Entities.clear();
+
+	// Added then removed: the observers never saw the component, so nothing is reported.
+	const Entity transient = world.CreateEntity();
+	world.AddComponent(transient, HealthComponent{2.f});
+	world.RemoveComponent<HealthComponent>(transient);
+
+	// Added then destroyed with the entity: nothing either.
+	const Entity destroyed = world.CreateEntity();
+	world.AddComponent(destroyed, HealthComponent{3.f});
+	world.DestroyEntity(destroyed);
+
+	// Removed then added back: the observers saw the old component, so both events are reported.
+	world.RemoveComponent<HealthComponent>(existing);
+	world.AddComponent(existing, HealthComponent{4.f});
+
+	world.FlushObservers();
+	ExpectToBeTrue((added.Entities.size() == 1))
+	ExpectToBeTrue(added.Saw(existing))
+	ExpectToBeTrue((removed.Entities.size() == 1))
+	ExpectToBeTrue(removed.Saw(existing))
+
+	// Events are reported once.
+	added.Entities.clear();
+	removed.Entities.clear();
+	world.FlushObservers();
+	ExpectToBeTrue(added.Entities.empty())
+	ExpectToBeTrue(removed.Entities.empty())
+
+	return true;
+}
+
+char ObserverSetAfterAddTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<HealthComponent>();
+
+	Recorder added;
+	Recorder set;
+	world.Observe<HealthComponent>(ComponentEvent::Added, added.Callback());
+	world.Observe<HealthComponent>(ComponentEvent::Set, set.Callback());
+
+	const Entity older = world.CreateEntity();
+	world.AddComponent(older, HealthComponent{1.f});
+	world.FlushObservers();
+	set.Entities.clear();
+
+	const Entity fresh = world.CreateEntity();
+	world.AddComponent(fresh, HealthComponent{2.f});
+	world.GetComponent<HealthComponent>(fresh).Value = 3.f;
+	world.GetComponent<HealthComponent>(older).Value = 4.f;
+
+	world.FlushObservers();
+	ExpectToBeTrue(added.Saw(fresh))
+	ExpectToBeTrue(!set.Saw(fresh))
+	ExpectToBeTrue(set.Saw(older))
+
+	// Once reported as added, later writes are reported as set.
+	set.Entities.clear();
+	world.GetComponent<HealthComponent>(fresh).Value = 5.f;
+	world.FlushObservers();
+	ExpectToBeTrue(set.Saw(fresh))
+	ExpectToBeTrue(!set.Saw(older))
+
+	return true;
+}
@@ -0,0 +1,11 @@
+﻿#pragma once
+
+/**
+ * \brief Adds and removes components between two flushes and checks only the net effect is reported.
+ */
+char ObserverCancellationTest();
+
+/**
+ * \brief Writes components added in the same batch and checks they are reported as added but not as set.
+ */
+char ObserverSetAfterAddTest();
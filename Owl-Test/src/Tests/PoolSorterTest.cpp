@@ -0,0 +1,141 @@
+﻿#include "PoolSorterTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/Group.h"
+#include "Owl/ECS/PoolSorter.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	constexpr uint32_t k_Count = 5000;
+
+	struct KeyComponent
+	{
+		uint32_t Key;
+		uint32_t Id;
+	};
+
+	struct PayloadComponent
+	{
+		uint32_t Id;
+	};
+
+	// Pools are iterated back to front, so the reversed visit order is the dense order.
+	template <typename T>
+	std::vector<Entity> GetDenseOrder(World& pWorld)
+	{
+		std::vector<Entity> order;
+		pWorld.View<const T>().Each([&order](const Entity pEntity, const T&) { order.push_back(pEntity); });
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
+	std::vector<Entity> Populate(World& pWorld, const bool pWithPayload)
+	{
+		std::mt19937 random(11);
+		std::vector<Entity> entities;
+		for (uint32_t i = 0; i < k_Count; ++i)
+		{
+			const Entity entity = pWorld.CreateEntity();
+			pWorld.AddComponent(entity, KeyComponent{static_cast<uint32_t>(random() % 100000), i});
+			if (pWithPayload && random() % 3 != 0)
+				pWorld.AddComponent(entity, PayloadComponent{i});
+			entities.push_back(entity);
+		}
+
+		// Swap-and-pop removals scatter whatever order the insertions left.
+		for (uint32_t i = 0; i < k_Count; i += 7)
+			pWorld.DestroyEntity(entities[i]);
+		return entities;
+	}
+
+	bool HasAscendingKeys(World& pWorld, const std::vector<Entity>& pOrder)
+	{
+		return std::is_sorted(pOrder.begin(), pOrder.end(), [&pWorld](const Entity pLeft, const Entity pRight)
+		{
+			return pWorld.GetComponent<KeyComponent>(pLeft).Key < pWorld.GetComponent<KeyComponent>(pRight).Key;
+		});
+	}
+}
+
+char PoolSorterMirrorTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<KeyComponent>();
+	world.RegisterComponent<PayloadComponent>();
+	Populate(world, true);
+
+	auto sorter = PoolSorter::Create<KeyComponent>(world, [](Entity, const KeyComponent& pComponent) { return pComponent.Key; });
+	sorter.Mirror<PayloadComponent>(world);
+
+	uint32_t runs = 1;
+	while (!sorter.Run(0.01f))
+		++runs;
+	ExpectToBeTrue((runs > 1))
+
+	const std::vector<Entity> order = GetDenseOrder<KeyComponent>(world);
+	ExpectToBeTrue(HasAscendingKeys(world, order))
+
+	// The mirrored pool holds the entities it shares with the sorted pool first, in the same order.
+	std::vector<Entity> shared;
+	for (const Entity entity : order)
+	{
+		if (world.HasComponent<PayloadComponent>(entity))
+			shared.push_back(entity);
+	}
+	const std::vector<Entity> mirrored = GetDenseOrder<PayloadComponent>(world);
+	ExpectToBeTrue((mirrored.size() == shared.size()))
+	ExpectToBeTrue(std::equal(shared.begin(), shared.end(), mirrored.begin()))
+
+	for (const Entity entity : order)
+	{
+		if (const PayloadComponent* payload = world.TryGetComponent<PayloadComponent>(entity))
+			ExpectToBeTrue((payload->Id == world.GetComponent<KeyComponent>(entity).Id))
+	}
+
+	return true;
+}
+
+char PoolSorterGroupTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<KeyComponent>();
+	world.RegisterComponent<PayloadComponent>();
+	Populate(world, true);
+
+	const Group<KeyComponent, PayloadComponent> group = world.Group<KeyComponent, PayloadComponent>();
+	const size_t size = group.Size();
+
+	auto sorter = PoolSorter::Create<KeyComponent>(world, [](Entity, const KeyComponent& pComponent) { return pComponent.Key; });
+	while (!sorter.Run(0.01f))
+	{
+	}
+
+	ExpectToBeTrue((group.Size() == size))
+	const std::vector<Entity> grouped(group.GetEntities().begin(), group.GetEntities().end());
+	ExpectToBeTrue(HasAscendingKeys(world, grouped))
+
+	// Both pools keep the grouped entities in their leading slots, in the same order.
+	const std::vector<Entity> keys = GetDenseOrder<KeyComponent>(world);
+	const std::vector<Entity> payloads = GetDenseOrder<PayloadComponent>(world);
+	ExpectToBeTrue(std::equal(grouped.begin(), grouped.end(), keys.begin()))
+	ExpectToBeTrue(std::equal(grouped.begin(), grouped.end(), payloads.begin()))
+
+	size_t visited = 0;
+	group.Each([&visited](const KeyComponent& pKey, const PayloadComponent& pPayload)
+	{
+		visited += pKey.Id == pPayload.Id;
+	});
+	ExpectToBeTrue((visited == size))
+
+	return true;
+}
@@ -0,0 +1,11 @@
+﻿#pragma once
+
+/**
+ * \brief Sorts a pool over several budgeted runs and checks the keys ascend and a mirrored pool follows the same order.
+ */
+char PoolSorterMirrorTest();
+
+/**
+ * \brief Sorts a pool owned by a group and checks the keys ascend and the grouped pools stay in lockstep.
+ */
+char PoolSorterGroupTest();
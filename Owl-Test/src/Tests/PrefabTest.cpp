@@ -0,0 +1,68 @@
+﻿#include "PrefabTest.h"
+
+#include <string>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/Prefab.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct HealthComponent
+	{
+		float Value;
+	};
+
+	struct NameComponent
+	{
+		std::string Value;
+	};
+
+	struct EnemyTag
+	{
+	};
+
+	bool InstantiatesCopies(const StorageMode pStorageMode)
+	{
+		World world;
+		world.Initialize(pStorageMode);
+		world.RegisterComponent<HealthComponent>();
+		world.RegisterComponent<NameComponent>();
+		world.RegisterComponent<EnemyTag>();
+
+		// Long enough to live on the heap, so each copy owns its own buffer.
+		const std::string name = "an enemy with a name longer than the small string buffer";
+		Prefab prefab(world);
+		prefab.Add(HealthComponent{100.f}).Add(NameComponent{name}).Add(EnemyTag{});
+
+		const std::vector<Entity> entities = world.Instantiate(prefab, 500);
+		if (entities.size() != 500)
+			return false;
+
+		for (const Entity entity : entities)
+		{
+			if (world.GetComponent<HealthComponent>(entity).Value != 100.f || world.GetComponent<NameComponent>(entity).Value != name ||
+				!world.HasComponent<EnemyTag>(entity))
+				return false;
+		}
+
+		// Copies never share state with each other or with the prototype.
+		world.GetComponent<NameComponent>(entities[0]).Value = "renamed";
+		world.GetComponent<HealthComponent>(entities[0]).Value = 1.f;
+		const std::vector<Entity> more = world.Instantiate(prefab, 2);
+		return world.GetComponent<NameComponent>(entities[1]).Value == name && world.GetComponent<HealthComponent>(entities[1]).Value == 100.f &&
+			world.GetComponent<NameComponent>(more[1]).Value == name;
+	}
+}
+
+char PrefabInstantiateTest()
+{
+	ExpectToBeTrue(InstantiatesCopies(StorageMode::ComponentPools))
+	ExpectToBeTrue(InstantiatesCopies(StorageMode::Archetypes))
+
+	return true;
+}
@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Instantiates a prefab with component pools and with archetypes, and checks every copy holds every prototype.
+ */
+char PrefabInstantiateTest();
@@ -0,0 +1,202 @@
+﻿#include "SpatialIndexTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+#include "Owl/ECS/Systems/SpatialIndex.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	constexpr uint32_t k_Count = 2000;
+	constexpr float k_Extent = 50.f;
+	constexpr float k_CellSize = 4.f;
+
+	struct Scene
+	{
+		std::mt19937 Random{7};
+		std::uniform_real_distribution<float> Coordinate{-k_Extent, k_Extent};
+		std::vector<Entity> Entities;
+
+		Owl::Vector3 RandomPoint() { return {Coordinate(Random), Coordinate(Random), Coordinate(Random)}; }
+
+		Entity Spawn(World& pWorld)
+		{
+			Owl::TransformComponent transform;
+			transform.Position = RandomPoint();
+			const Entity entity = pWorld.CreateEntity();
+			pWorld.AddComponent(entity, transform);
+			return entity;
+		}
+	};
+
+	void Setup(World& pWorld, Scene& pScene)
+	{
+		pWorld.Initialize(StorageMode::ComponentPools, k_Count);
+		pWorld.RegisterComponent<Owl::TransformComponent>();
+		for (uint32_t i = 0; i < k_Count; ++i)
+			pScene.Entities.push_back(pScene.Spawn(pWorld));
+	}
+
+	// Edits the world after the index was built from it: the moves of entities that existed before the index
+	// must reach it like the others.
+	void Edit(World& pWorld, Scene& pScene)
+	{
+		for (uint32_t i = 0; i < k_Count; i += 3)
+			pWorld.GetComponent<Owl::TransformComponent>(pScene.Entities[i]).Position = pScene.RandomPoint();
+		for (uint32_t i = 1; i < k_Count; i += 7)
+			pWorld.GetComponent<Owl::TransformComponent>(pScene.Entities[i]).Position += Owl::Vector3(0.5f, 0.f, 0.f);
+		for (uint32_t i = 2; i < k_Count; i += 11)
+		{
+			pWorld.DestroyEntity(pScene.Entities[i]);
+			pScene.Entities[i] = pScene.Spawn(pWorld);
+		}
+		pWorld.FlushObservers();
+	}
+
+	bool IsIndexed(const World& pWorld, const SpatialIndex& pIndex)
+	{
+		size_t count = 0;
+		bool isIndexed = true;
+		pWorld.View<const Owl::TransformComponent>().Each([&](const Entity pEntity, const Owl::TransformComponent&)
+		{
+			isIndexed &= pIndex.Contains(pEntity);
+			++count;
+		});
+		return isIndexed && count == pIndex.GetSize();
+	}
+}
+
+char SpatialIndexNearestTest()
+{
+	World world;
+	Scene scene;
+	Setup(world, scene);
+	const SpatialIndex index(world, k_CellSize);
+	Edit(world, scene);
+
+	const World& view = world;
+	ExpectToBeTrue(IsIndexed(view, index))
+
+	constexpr uint32_t nearestCount = 8;
+	std::vector<Entity> nearest;
+	std::vector<std::pair<float, Entity>> scan;
+	for (uint32_t query = 0; query < 200; ++query)
+	{
+		const Owl::Vector3 point = scene.RandomPoint();
+		index.QueryNearest(point, nearestCount, nearest);
+
+		scan.clear();
+		view.View<const Owl::TransformComponent>().Each([&](const Entity pEntity, const Owl::TransformComponent& pTransform)
+		{
+			scan.emplace_back((pTransform.Position - point).LenghtSquared(), pEntity);
+		});
+		std::partial_sort(scan.begin(), scan.begin() + nearestCount, scan.end());
+
+		ExpectToBeTrue((nearest.size() == nearestCount))
+		for (uint32_t i = 0; i < nearestCount; ++i)
+			ExpectToBeTrue((nearest[i] == scan[i].second))
+	}
+
+	return true;
+}
+
+char SpatialIndexRaycastTest()
+{
+	World world;
+	Scene scene;
+	Setup(world, scene);
+	const SpatialIndex index(world, k_CellSize);
+	Edit(world, scene);
+
+	const World& view = world;
+	ExpectToBeTrue(IsIndexed(view, index))
+
+	constexpr float radius = 1.5f;
+	constexpr float maxDistance = 4.f * k_Extent;
+	uint32_t hits = 0;
+	for (uint32_t query = 0; query < 200; ++query)
+	{
+		const Owl::Vector3 origin = scene.RandomPoint();
+		const Owl::Vector3 direction = (scene.RandomPoint() - origin).Normalized();
+
+		RaycastHit hit;
+		const bool isHit = index.Raycast(origin, direction, maxDistance, radius, hit);
+
+		// The first sphere along the ray, a ray starting inside a sphere hitting it at distance zero.
+		RaycastHit closest{NULL_ENTITY, maxDistance};
+		view.View<const Owl::TransformComponent>().Each([&](const Entity pEntity, const Owl::TransformComponent& pTransform)
+		{
+			const Owl::Vector3 toCenter = pTransform.Position - origin;
+			const float along = toCenter.Dot(direction);
+			const float missSquared = toCenter.LenghtSquared() - along * along;
+			if (missSquared > radius * radius)
+				return;
+
+			const float halfChord = std::sqrt(radius * radius - missSquared);
+			const float distance = along - halfChord >= 0.f ? along - halfChord : along + halfChord >= 0.f ? 0.f : -1.f;
+			if (distance >= 0.f && distance <= closest.Distance && (closest.Target == NULL_ENTITY || distance < closest.Distance))
+				closest = {pEntity, distance};
+		});
+
+		ExpectToBeTrue((isHit == (closest.Target != NULL_ENTITY)))
+		if (!isHit)
+			continue;
+
+		++hits;
+		ExpectToBeTrue((hit.Target == closest.Target))
+		ExpectToBeTrue((std::abs(hit.Distance - closest.Distance) <= 1e-4f * std::max(1.f, closest.Distance)))
+	}
+
+	// Enough rays must hit for the comparison to mean something.
+	ExpectToBeTrue((hits > 50))
+
+	return true;
+}
+
+char SpatialIndexRadiusTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<Owl::TransformComponent>();
+
+	const SpatialIndex index(world, 1.f);
+	uint32_t found = 0;
+	index.QueryRadius(Owl::Vector3(0.f, 0.f, 0.f), 400.f, [&found](Entity, const Owl::Vector3&) { ++found; });
+	ExpectToBeTrue((found == 0))
+
+	Scene scene;
+	for (uint32_t i = 0; i < 10; ++i)
+		scene.Entities.push_back(scene.Spawn(world));
+	world.FlushObservers();
+
+	const World& view = world;
+	for (const float radius : {0.5f, 10.f, 60.f, 100.f, 400.f})
+	{
+		const Owl::Vector3 center = scene.RandomPoint();
+
+		std::vector<Entity> inside;
+		index.QueryRadius(center, radius, [&inside](const Entity pEntity, const Owl::Vector3&) { inside.push_back(pEntity); });
+
+		std::vector<Entity> scan;
+		view.View<const Owl::TransformComponent>().Each([&](const Entity pEntity, const Owl::TransformComponent& pTransform)
+		{
+			if ((pTransform.Position - center).LenghtSquared() <= radius * radius)
+				scan.push_back(pEntity);
+		});
+
+		std::sort(inside.begin(), inside.end());
+		std::sort(scan.begin(), scan.end());
+		ExpectToBeTrue((inside == scan))
+	}
+
+	return true;
+}
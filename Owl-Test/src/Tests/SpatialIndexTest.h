@@ -0,0 +1,16 @@
+﻿#pragma once
+
+/**
+ * \brief Moves, adds and destroys entities around a spatial index, then checks QueryNearest against a full scan.
+ */
+char SpatialIndexNearestTest();
+
+/**
+ * \brief Moves, adds and destroys entities around a spatial index, then checks Raycast against a full scan.
+ */
+char SpatialIndexRaycastTest();
+
+/**
+ * \brief Checks QueryRadius against a full scan on a sparse index with small cells, up to radii far past its bounds.
+ */
+char SpatialIndexRadiusTest();
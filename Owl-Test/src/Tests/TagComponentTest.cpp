@@ -0,0 +1,94 @@
+﻿#include "TagComponentTest.h"
+
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	struct HealthComponent
+	{
+		float Value;
+	};
+
+	struct EnemyTag
+	{
+	};
+
+	struct SelectedTag
+	{
+	};
+
+	struct SelectionSystem : System
+	{
+		using System::System;
+	};
+}
+
+char TagComponentViewTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<HealthComponent>();
+	world.RegisterComponent<EnemyTag>();
+	world.RegisterComponent<SelectedTag>();
+
+	const auto selection = world.RegisterSystem<SelectionSystem>();
+	Signature signature;
+	signature.set(world.GetComponentType<SelectedTag>());
+	world.SetSystemSignature<SelectionSystem>(signature);
+
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 12; ++i)
+	{
+		const Entity entity = world.CreateEntity();
+		world.AddComponent(entity, HealthComponent{static_cast<float>(i)});
+		if (i % 2 == 0)
+			world.AddComponent(entity, EnemyTag{});
+		if (i % 3 == 0)
+			world.AddComponent(entity, SelectedTag{});
+		entities.push_back(entity);
+	}
+
+	// A selected entity without any stored component is only reachable through the system.
+	const Entity marker = world.CreateEntity();
+	world.AddComponent(marker, SelectedTag{});
+
+	float enemyHealth = 0.f;
+	uint32_t enemies = 0;
+	world.View<HealthComponent, EnemyTag>().Each([&](const Entity pEntity, HealthComponent& pHealth)
+	{
+		enemyHealth += pHealth.Value;
+		enemies += world.HasComponent<EnemyTag>(pEntity);
+	});
+	ExpectToBeTrue((enemies == 6))
+	ExpectToBeTrue((enemyHealth == 0.f + 2.f + 4.f + 6.f + 8.f + 10.f))
+
+	uint32_t selectedEnemies = 0;
+	world.View<const HealthComponent, EnemyTag, SelectedTag>().Each([&](const HealthComponent& pHealth)
+	{
+		selectedEnemies += static_cast<uint32_t>(pHealth.Value) % 6 == 0;
+	});
+	ExpectToBeTrue((selectedEnemies == 2))
+
+	world.RemoveComponent<EnemyTag>(entities[0]);
+	const uint32_t since = world.AdvanceChangeTick();
+	world.GetComponent<HealthComponent>(entities[2]).Value = 20.f;
+	world.GetComponent<HealthComponent>(entities[3]).Value = 30.f;
+
+	uint32_t changedEnemies = 0;
+	world.View<Changed<HealthComponent>, const HealthComponent, EnemyTag>(since).Each([&](const Entity pEntity, const HealthComponent&)
+	{
+		changedEnemies += pEntity == entities[2];
+	});
+	ExpectToBeTrue((changedEnemies == 1))
+
+	ExpectToBeTrue((selection->GetEntities().Size() == 5))
+	ExpectToBeTrue(selection->GetEntities().Contains(marker))
+
+	return true;
+}
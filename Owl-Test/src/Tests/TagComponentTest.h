@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Iterates the entities carrying tags through a View filter and through a system signature holding a tag alone.
+ */
+char TagComponentViewTest();
@@ -0,0 +1,101 @@
+﻿#include "TransformSystemTest.h"
+
+#include <memory>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/ChildrenComponent.h"
+#include "Owl/ECS/Components/ParentComponent.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+#include "Owl/ECS/Components/WorldTransformComponent.h"
+#include "Owl/ECS/Systems/TransformSystem.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	std::shared_ptr<TransformSystem> Setup(World& pWorld)
+	{
+		pWorld.Initialize();
+		pWorld.RegisterComponent<Owl::TransformComponent>();
+		pWorld.RegisterComponent<Owl::WorldTransformComponent>();
+		pWorld.RegisterComponent<Owl::ParentComponent>();
+		pWorld.RegisterComponent<Owl::ChildrenComponent>();
+		return pWorld.RegisterSystem<TransformSystem>();
+	}
+
+	Entity CreateNode(World& pWorld, const float pX)
+	{
+		Owl::TransformComponent transform;
+		transform.Position.x = pX;
+
+		const Entity entity = pWorld.CreateEntity();
+		pWorld.AddComponent(entity, transform);
+		pWorld.AddComponent(entity, Owl::WorldTransformComponent{});
+		return entity;
+	}
+
+	float GetWorldX(const World& pWorld, const Entity pEntity)
+	{
+		return pWorld.GetComponent<Owl::WorldTransformComponent>(pEntity).Matrix.Data[12];
+	}
+}
+
+char TransformSystemDestroyedChildTest()
+{
+	World world;
+	const auto transforms = Setup(world);
+
+	const Entity root = CreateNode(world, 100.f);
+	const Entity parent = CreateNode(world, 10.f);
+	const Entity destroyed = CreateNode(world, 1.f);
+	const Entity child = CreateNode(world, 2.f);
+	transforms->SetParent(destroyed, parent);
+	transforms->SetParent(child, parent);
+	world.Update(0.f);
+
+	world.DestroyEntity(destroyed);
+	transforms->SetParent(parent, root);
+	world.Update(0.f);
+
+	const World& view = world;
+	ExpectToBeTrue((view.GetComponent<Owl::ChildrenComponent>(parent).Children.size() == 1))
+	ExpectToBeTrue((view.GetComponent<Owl::ChildrenComponent>(parent).Children.front() == child))
+	ExpectToBeTrue((view.GetComponent<Owl::ParentComponent>(child).Depth == 2))
+	ExpectToBeTrue((GetWorldX(view, child) == 112.f))
+
+	return true;
+}
+
+char TransformSystemDestroyedParentTest()
+{
+	World world;
+	const auto transforms = Setup(world);
+
+	const Entity root = CreateNode(world, 100.f);
+	const Entity child = CreateNode(world, 2.f);
+	const Entity grandChild = CreateNode(world, 1.f);
+	transforms->SetParent(child, root);
+	transforms->SetParent(grandChild, child);
+	world.Update(0.f);
+
+	const World& view = world;
+	ExpectToBeTrue((GetWorldX(view, child) == 102.f))
+	ExpectToBeTrue((GetWorldX(view, grandChild) == 103.f))
+
+	world.DestroyEntity(root);
+	world.Update(0.f);
+
+	ExpectToBeFalse(view.HasComponent<Owl::ParentComponent>(child))
+	ExpectToBeTrue((view.GetComponent<Owl::ParentComponent>(grandChild).Depth == 1))
+	ExpectToBeTrue((GetWorldX(view, child) == 2.f))
+	ExpectToBeTrue((GetWorldX(view, grandChild) == 3.f))
+
+	// Stays a root: later updates do not pick the dead parent up again.
+	world.GetComponent<Owl::TransformComponent>(child).Position.x = 5.f;
+	world.Update(0.f);
+	ExpectToBeTrue((GetWorldX(view, grandChild) == 6.f))
+
+	return true;
+}
@@ -0,0 +1,11 @@
+﻿#pragma once
+
+/**
+ * \brief Destroys a child, then reparents its former parent: the dead handle must be dropped from the children list.
+ */
+char TransformSystemDestroyedChildTest();
+
+/**
+ * \brief Destroys a parent: its children must become roots, with world matrices no longer relative to it.
+ */
+char TransformSystemDestroyedParentTest();
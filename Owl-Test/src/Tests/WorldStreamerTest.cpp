@@ -0,0 +1,77 @@
+﻿#include "WorldStreamerTest.h"
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Expect.h"
+#include "Owl/Core/Base.h"
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/WorldStreamer.h"
+
+namespace
+{
+	using namespace Owl::Ecs;
+
+	constexpr uint32_t k_CellSize = 64;
+	constexpr CellId k_Cell = 3;
+
+	struct LinkComponent
+	{
+		uint32_t Id;
+		Entity Target;
+	};
+}
+
+char WorldStreamerRoundTripTest()
+{
+	World world;
+	world.Initialize();
+	world.RegisterComponent<LinkComponent>();
+
+	const Entity outside = world.CreateEntity();
+
+	// Each entity links to the previous one of the cell, and every fourth one to the entity outside of it.
+	std::vector<Entity> cell;
+	for (uint32_t i = 0; i < k_CellSize; ++i)
+	{
+		const Entity entity = world.CreateEntity();
+		const Entity target = i % 4 == 0 ? outside : cell.back();
+		world.AddComponent(entity, LinkComponent{i, target});
+		cell.push_back(entity);
+	}
+
+	const std::string path = (std::filesystem::temp_directory_path() / "OwlWorldStreamerTest.cell").string();
+	{
+		WorldStreamer streamer(world);
+		streamer.AddEntityField(&LinkComponent::Target);
+		streamer.AddToCell(k_Cell, cell);
+
+		streamer.UnloadCell(k_Cell, path);
+		for (const Entity entity : cell)
+			ExpectToBeTrue(!world.IsAlive(entity))
+
+		streamer.RequestLoad(k_Cell, path);
+		streamer.Wait();
+		ExpectToBeTrue((streamer.SpliceLoadedCells() == 1))
+
+		const std::span<const Entity> loaded = streamer.GetEntities(k_Cell);
+		ExpectToBeTrue((loaded.size() == k_CellSize))
+
+		std::vector<Entity> byId(k_CellSize, NULL_ENTITY);
+		for (const Entity entity : loaded)
+			byId[world.GetComponent<LinkComponent>(entity).Id] = entity;
+
+		for (uint32_t i = 0; i < k_CellSize; ++i)
+		{
+			ExpectToBeTrue((byId[i] != NULL_ENTITY))
+			const Entity target = world.GetComponent<LinkComponent>(byId[i]).Target;
+			ExpectToBeTrue((target == (i % 4 == 0 ? NULL_ENTITY : byId[i - 1])))
+		}
+		ExpectToBeTrue(world.IsAlive(outside))
+	}
+	std::filesystem::remove(path);
+
+	return true;
+}
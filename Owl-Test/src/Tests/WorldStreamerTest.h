@@ -0,0 +1,6 @@
+﻿#pragma once
+
+/**
+ * \brief Unloads a cell and loads it back, and checks entity fields follow the new handles and outside references are nulled.
+ */
+char WorldStreamerRoundTripTest();
@@ -42,6 +42,12 @@ project "Owl"
 	
 	flags { "NoPCH" }
 
+	-- The only file allowed to contain AVX2 code; TransformBatch picks it at runtime when the CPU supports it.
+	-- It stays off the precompiled header, whose inline functions would otherwise be emitted as AVX2.
+	filter "files:src/Owl/ECS/Systems/TransformBatchAvx2.cpp"
+		vectorextensions "AVX2"
+		flags { "NoPCH" }
+
     filter "system:windows"
 		systemversion "latest"
 
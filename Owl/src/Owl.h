@@ -8,3 +8,13 @@
 
 #include "Owl/ECS/World.h"
 #include "Owl/ECS/Ecs.h"
+#include "Owl/ECS/System.h"
+#include "Owl/ECS/EcsCommandBuffer.h"
+#include "Owl/ECS/ObserverManager.h"
+#include "Owl/ECS/ResourceManager.h"
+#include "Owl/ECS/Prefab.h"
+#include "Owl/ECS/PoolSorter.h"
+#include "Owl/ECS/WorldSnapshot.h"
+#include "Owl/ECS/WorldStreamer.h"
+#include "Owl/ECS/Systems/TransformSystem.h"
+#include "Owl/ECS/Systems/SpatialIndex.h"
@@ -0,0 +1,56 @@
+﻿#include "opch.h"
+#include "ThreadPool.h"
+
+namespace Owl
+{
+	ThreadPool::ThreadPool(uint32_t pThreadCount)
+	{
+		if (pThreadCount == 0)
+			pThreadCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+
+		m_Workers.reserve(pThreadCount);
+		for (uint32_t i = 0; i < pThreadCount; ++i)
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_IsStopping = true;
+		}
+		m_Condition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	void ThreadPool::Submit(std::function<void()> pJob)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Jobs.push(std::move(pJob));
+		}
+		m_Condition.notify_one();
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock lock(m_Mutex);
+				m_Condition.wait(lock, [this] { return m_IsStopping || !m_Jobs.empty(); });
+
+				if (m_IsStopping && m_Jobs.empty())
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop();
+			}
+
+			job();
+		}
+	}
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Owl
+{
+	class ThreadPool
+	{
+	public:
+		/**
+		 * \brief Starts the worker threads.
+		 * \param pThreadCount Number of workers; 0 uses one less than the hardware concurrency.
+		 */
+		explicit ThreadPool(uint32_t pThreadCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * \brief Queues a job to be run by the first available worker.
+		 */
+		void Submit(std::function<void()> pJob);
+
+		[[nodiscard]] uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Workers;
+		std::queue<std::function<void()>> m_Jobs;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		bool m_IsStopping = false;
+	};
+}
@@ -0,0 +1,109 @@
+﻿#include "opch.h"
+#include "Archetype.h"
+
+namespace Owl::Ecs
+{
+	Archetype::Archetype(const Signature pSignature, const std::array<ComponentInfo, MAX_COMPONENTS>& pComponentInfos)
+		: m_Signature(pSignature)
+	{
+		size_t bytesPerRow = sizeof(Entity);
+		for (ComponentType type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			if (!m_Signature.test(type))
+				continue;
+
+			const ComponentInfo& info = pComponentInfos[type];
+			OWL_CORE_ASSERT(info.Size > 0, "Component not registered before use.")
+			OWL_CORE_ASSERT(info.Alignment <= alignof(std::max_align_t), "Component alignment is not supported by archetype chunks.")
+
+			if (info.IsTag)
+				continue;
+
+			m_ColumnIndices[type] = static_cast<uint8_t>(m_Columns.size());
+			m_Columns.push_back({type, 0, info});
+			bytesPerRow += info.Size;
+		}
+
+		const auto computeLayout = [this](const uint32_t pCapacity)
+		{
+			size_t offset = pCapacity * sizeof(Entity);
+			for (Column& column : m_Columns)
+			{
+				offset = (offset + column.Info.Alignment - 1) & ~(column.Info.Alignment - 1);
+				column.Offset = offset;
+				offset += pCapacity * column.Info.Size;
+			}
+			return offset;
+		};
+
+		m_ChunkCapacity = std::max<uint32_t>(1, static_cast<uint32_t>(k_ChunkSize / bytesPerRow));
+		while (m_ChunkCapacity > 1 && computeLayout(m_ChunkCapacity) > k_ChunkSize)
+			--m_ChunkCapacity;
+		m_ChunkBytes = std::max(k_ChunkSize, computeLayout(m_ChunkCapacity));
+	}
+
+	Archetype::~Archetype()
+	{
+		for (uint32_t row = 0; row < m_Size; ++row)
+		{
+			for (const Column& column : m_Columns)
+				column.Info.Destroy(GetComponent(column.Type, row));
+		}
+
+		for (std::byte* chunk : m_Chunks)
+			OWL_FREE(chunk, m_ChunkBytes, MemoryTagEcs);
+	}
+
+	uint32_t Archetype::PushBack(const Entity pEntity)
+	{
+		if (m_Size == m_Chunks.size() * m_ChunkCapacity)
+			m_Chunks.push_back(static_cast<std::byte*>(OWL_ALLOCATE(m_ChunkBytes, MemoryTagEcs)));
+
+		const uint32_t row = m_Size++;
+		GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity] = pEntity;
+		return row;
+	}
+
+	Entity Archetype::RemoveRow(const uint32_t pRow)
+	{
+		OWL_CORE_ASSERT(pRow < m_Size, "Removing non-existent archetype row.")
+
+		const uint32_t lastRow = m_Size - 1;
+		Entity& entity = GetEntities(pRow / m_ChunkCapacity)[pRow % m_ChunkCapacity];
+
+		for (const Column& column : m_Columns)
+		{
+			void* component = GetComponent(column.Type, pRow);
+			column.Info.Destroy(component);
+
+			if (pRow != lastRow)
+			{
+				void* lastComponent = GetComponent(column.Type, lastRow);
+				column.Info.MoveConstruct(component, lastComponent);
+				column.Info.Destroy(lastComponent);
+			}
+		}
+
+		if (pRow != lastRow)
+			entity = GetEntities(lastRow / m_ChunkCapacity)[lastRow % m_ChunkCapacity];
+		const Entity movedEntity = entity;
+
+		--m_Size;
+		if (m_Size == (m_Chunks.size() - 1) * m_ChunkCapacity)
+		{
+			OWL_FREE(m_Chunks.back(), m_ChunkBytes, MemoryTagEcs);
+			m_Chunks.pop_back();
+		}
+
+		return movedEntity;
+	}
+
+	void Archetype::MoveRowFrom(const uint32_t pRow, Archetype& pSource, const uint32_t pSourceRow)
+	{
+		for (const Column& column : m_Columns)
+		{
+			if (pSource.HasComponent(column.Type))
+				column.Info.MoveConstruct(GetComponent(column.Type, pRow), pSource.GetComponent(column.Type, pSourceRow));
+		}
+	}
+}
@@ -0,0 +1,124 @@
+﻿#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Ecs.h"
+
+namespace Owl::Ecs
+{
+	struct ComponentInfo
+	{
+		size_t Size = 0;
+		size_t Alignment = 0;
+		bool IsTag = false;
+		void (*MoveConstruct)(void* pDestination, void* pSource) = nullptr;
+		void (*Destroy)(void* pComponent) = nullptr;
+
+		template <typename T>
+		static ComponentInfo Create()
+		{
+			ComponentInfo info;
+			info.Size = sizeof(T);
+			info.Alignment = alignof(T);
+			info.IsTag = IsTagComponent<T>;
+			info.MoveConstruct = [](void* pDestination, void* pSource)
+			{
+				new(pDestination) T(std::move(*static_cast<T*>(pSource)));
+			};
+			info.Destroy = [](void* pComponent) { static_cast<T*>(pComponent)->~T(); };
+			return info;
+		}
+	};
+
+	/**
+	 * \brief Stores every entity sharing the same Signature in fixed-size chunks.
+	 * Each chunk holds an entity column followed by one packed column per component other than tags,
+	 * and rows are kept dense across chunks so only the last chunk is partially filled.
+	 */
+	class Archetype
+	{
+	public:
+		static constexpr size_t k_ChunkSize = 16 * 1024;
+
+		Archetype(Signature pSignature, const std::array<ComponentInfo, MAX_COMPONENTS>& pComponentInfos);
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		/**
+		 * \brief Claims a new row for the entity. Component slots of the row are left uninitialized.
+		 * \return The index of the new row.
+		 */
+		uint32_t PushBack(Entity pEntity);
+
+		/**
+		 * \brief Destroys the components of a row and fills the hole with the last row.
+		 * \return The entity moved into pRow, or pRow's own entity when it was the last row.
+		 */
+		Entity RemoveRow(uint32_t pRow);
+
+		/**
+		 * \brief Move constructs every component this archetype shares with pSource from pSourceRow into pRow.
+		 */
+		void MoveRowFrom(uint32_t pRow, Archetype& pSource, uint32_t pSourceRow);
+
+		[[nodiscard]] bool HasComponent(const ComponentType pType) const { return m_Signature.test(pType); }
+
+		[[nodiscard]] void* GetComponent(const ComponentType pType, const uint32_t pRow) const
+		{
+			OWL_CORE_ASSERT(HasComponent(pType), "Archetype does not contain the requested component.")
+
+			const Column& column = m_Columns[m_ColumnIndices[pType]];
+			return m_Chunks[pRow / m_ChunkCapacity] + column.Offset + pRow % m_ChunkCapacity * column.Info.Size;
+		}
+
+		template <typename T>
+		[[nodiscard]] T* GetColumn(const ComponentType pType, const uint32_t pChunk) const
+		{
+			static_assert(!IsTagComponent<T>, "Tag components have no column.");
+			OWL_CORE_ASSERT(HasComponent(pType), "Archetype does not contain the requested component.")
+
+			return reinterpret_cast<T*>(m_Chunks[pChunk] + m_Columns[m_ColumnIndices[pType]].Offset);
+		}
+
+		[[nodiscard]] Entity* GetEntities(const uint32_t pChunk) const
+		{
+			return reinterpret_cast<Entity*>(m_Chunks[pChunk]);
+		}
+
+		[[nodiscard]] Signature GetSignature() const { return m_Signature; }
+		[[nodiscard]] uint32_t GetSize() const { return m_Size; }
+		[[nodiscard]] uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+		[[nodiscard]] uint32_t GetChunkCount() const { return static_cast<uint32_t>(m_Chunks.size()); }
+
+		[[nodiscard]] uint32_t GetChunkSize(const uint32_t pChunk) const
+		{
+			const uint32_t first = pChunk * m_ChunkCapacity;
+			return m_Size - first < m_ChunkCapacity ? m_Size - first : m_ChunkCapacity;
+		}
+
+		Archetype*& GetAddEdge(const ComponentType pType) { return m_AddEdges[pType]; }
+		Archetype*& GetRemoveEdge(const ComponentType pType) { return m_RemoveEdges[pType]; }
+
+	private:
+		struct Column
+		{
+			ComponentType Type;
+			size_t Offset;
+			ComponentInfo Info;
+		};
+
+		Signature m_Signature;
+		std::vector<Column> m_Columns;
+		std::array<uint8_t, MAX_COMPONENTS> m_ColumnIndices{};
+		std::vector<std::byte*> m_Chunks;
+		size_t m_ChunkBytes = k_ChunkSize;
+		uint32_t m_ChunkCapacity = 0;
+		uint32_t m_Size = 0;
+
+		std::array<Archetype*, MAX_COMPONENTS> m_AddEdges{};
+		std::array<Archetype*, MAX_COMPONENTS> m_RemoveEdges{};
+	};
+}
@@ -0,0 +1,80 @@
+﻿#include "opch.h"
+#include "ArchetypeManager.h"
+
+namespace Owl::Ecs
+{
+	void ArchetypeManager::EntityDestroyed(const Entity pEntity)
+	{
+		const uint32_t index = GetEntityIndex(pEntity);
+		if (index >= m_EntityLocations.size())
+			return;
+
+		EntityLocation& location = m_EntityLocations[index];
+		if (!location.Owner)
+			return;
+
+		if (const Entity moved = location.Owner->RemoveRow(location.Row); moved != pEntity)
+			m_EntityLocations[GetEntityIndex(moved)].Row = location.Row;
+
+		location = {};
+	}
+
+	void ArchetypeManager::Reserve(const uint32_t pEntityCount)
+	{
+		m_EntityLocations.reserve(pEntityCount);
+	}
+
+	void* ArchetypeManager::MoveEntity(const Entity pEntity, const ComponentType pType, const bool pAdd)
+	{
+		const uint32_t index = GetEntityIndex(pEntity);
+		if (index >= m_EntityLocations.size())
+			m_EntityLocations.resize(index + 1);
+
+		EntityLocation& location = m_EntityLocations[index];
+		Archetype* source = location.Owner;
+
+		OWL_CORE_ASSERT(!pAdd || !source || !source->HasComponent(pType), "Component added to same entity more than once.")
+		OWL_CORE_ASSERT(pAdd || (source && source->HasComponent(pType)), "Removing non-existent component.")
+
+		Archetype* target = nullptr;
+		if (source)
+		{
+			Archetype*& edge = pAdd ? source->GetAddEdge(pType) : source->GetRemoveEdge(pType);
+			if (!edge)
+				edge = GetOrCreateArchetype(Signature(source->GetSignature()).set(pType, pAdd));
+			target = edge;
+		}
+		else
+		{
+			target = GetOrCreateArchetype(Signature().set(pType));
+		}
+
+		const uint32_t row = target ? target->PushBack(pEntity) : 0;
+		if (source)
+		{
+			if (target)
+				target->MoveRowFrom(row, *source, location.Row);
+
+			if (const Entity moved = source->RemoveRow(location.Row); moved != pEntity)
+				m_EntityLocations[GetEntityIndex(moved)].Row = location.Row;
+		}
+
+		location = {target, row};
+		return pAdd && !m_ComponentInfos[pType].IsTag ? target->GetComponent(pType, row) : nullptr;
+	}
+
+	Archetype* ArchetypeManager::GetOrCreateArchetype(const Signature pSignature)
+	{
+		if (pSignature.none())
+			return nullptr;
+
+		auto& archetype = m_Archetypes[pSignature];
+		if (!archetype)
+		{
+			archetype = std::make_unique<Archetype>(pSignature, m_ComponentInfos);
+			m_ArchetypeList.push_back(archetype.get());
+		}
+
+		return archetype.get();
+	}
+}
@@ -0,0 +1,153 @@
+﻿#pragma once
+#include <memory>
+#include <span>
+#include <unordered_map>
+
+#include "Archetype.h"
+#include "Ecs.h"
+
+namespace Owl::Ecs
+{
+	class ArchetypeManager
+	{
+	public:
+		template <typename T>
+		void RegisterComponent(const ComponentType pType)
+		{
+			m_ComponentInfos[pType] = ComponentInfo::Create<T>();
+		}
+
+		template <typename T>
+		void AddComponent(const Entity pEntity, const ComponentType pType, T pComponent)
+		{
+			void* component = MoveEntity(pEntity, pType, true);
+			if constexpr (!IsTagComponent<T>)
+				new(component) T(std::move(pComponent));
+		}
+
+		void RemoveComponent(const Entity pEntity, const ComponentType pType)
+		{
+			MoveEntity(pEntity, pType, false);
+		}
+
+		template <typename T>
+		T& GetComponent(const Entity pEntity, const ComponentType pType)
+		{
+			static_assert(!IsTagComponent<T>, "Tag components have no storage; test them with HasComponent or a signature.");
+			OWL_CORE_ASSERT(GetEntityIndex(pEntity) < m_EntityLocations.size(), "Retrieving non-existent component.")
+
+			const EntityLocation& location = m_EntityLocations[GetEntityIndex(pEntity)];
+
+			OWL_CORE_ASSERT(location.Owner && location.Owner->HasComponent(pType), "Retrieving non-existent component.")
+
+			return *static_cast<T*>(location.Owner->GetComponent(pType, location.Row));
+		}
+
+		/**
+		 * \brief Appends freshly created entities straight into the archetype of pTypes, each with a copy of pComponents.
+		 */
+		template <typename... Ts>
+		void CreateEntities(const std::span<const Entity> pEntities, const std::array<ComponentType, sizeof...(Ts)>& pTypes,
+		                    const Ts&... pComponents)
+		{
+			Signature signature;
+			for (const ComponentType type : pTypes)
+				signature.set(type);
+
+			CreateEntities(pEntities, signature, [&](const Archetype& pArchetype, const uint32_t pRow)
+			{
+				ConstructRow(pArchetype, pRow, pTypes, std::index_sequence_for<Ts...>{}, pComponents...);
+			});
+		}
+
+		/**
+		 * \brief Appends freshly created entities straight into the archetype of pSignature.
+		 * \param pConstructRow Called as pConstructRow(archetype, row) to construct the components of each new row.
+		 */
+		template <typename Func>
+		void CreateEntities(const std::span<const Entity> pEntities, const Signature pSignature, Func&& pConstructRow)
+		{
+			Archetype* archetype = GetOrCreateArchetype(pSignature);
+			for (const Entity entity : pEntities)
+			{
+				const uint32_t index = GetEntityIndex(entity);
+				if (index >= m_EntityLocations.size())
+					m_EntityLocations.resize(index + 1);
+
+				if (!archetype)
+					continue;
+
+				const uint32_t row = archetype->PushBack(entity);
+				pConstructRow(static_cast<const Archetype&>(*archetype), row);
+				m_EntityLocations[index] = {archetype, row};
+			}
+		}
+
+		void EntityDestroyed(Entity pEntity);
+		void Reserve(uint32_t pEntityCount);
+
+		/**
+		 * \brief Calls pFunc([entity,] components...) for every entity owning all the requested components,
+		 * walking the packed chunk columns of each matching archetype.
+		 */
+		template <typename... Ts, typename Func>
+		void ForEach(const std::array<ComponentType, sizeof...(Ts)>& pTypes, Func&& pFunc)
+		{
+			Signature required;
+			for (const ComponentType type : pTypes)
+				required.set(type);
+
+			for (const auto& archetype : m_ArchetypeList)
+			{
+				if ((archetype->GetSignature() & required) != required)
+					continue;
+
+				for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+					ForEachInChunk<Ts...>(*archetype, chunk, pTypes, pFunc, std::index_sequence_for<Ts...>{});
+			}
+		}
+
+	private:
+		struct EntityLocation
+		{
+			Archetype* Owner = nullptr;
+			uint32_t Row = 0;
+		};
+
+		std::array<ComponentInfo, MAX_COMPONENTS> m_ComponentInfos{};
+		std::unordered_map<Signature, std::unique_ptr<Archetype>> m_Archetypes{};
+		std::vector<Archetype*> m_ArchetypeList{};
+		std::vector<EntityLocation> m_EntityLocations{};
+
+		void* MoveEntity(Entity pEntity, ComponentType pType, bool pAdd);
+		Archetype* GetOrCreateArchetype(Signature pSignature);
+
+		template <typename... Ts, size_t... Is>
+		static void ConstructRow(const Archetype& pArchetype, const uint32_t pRow,
+		                         const std::array<ComponentType, sizeof...(Ts)>& pTypes, std::index_sequence<Is...>,
+		                         const Ts&... pComponents)
+		{
+			(ConstructComponent(pArchetype, pTypes[Is], pRow, pComponents), ...);
+		}
+
+		template <typename T>
+		static void ConstructComponent(const Archetype& pArchetype, const ComponentType pType, const uint32_t pRow, const T& pComponent)
+		{
+			if constexpr (!IsTagComponent<T>)
+				new(pArchetype.GetComponent(pType, pRow)) T(pComponent);
+		}
+
+		template <typename... Ts, typename Func, size_t... Is>
+		static void ForEachInChunk(const Archetype& pArchetype, const uint32_t pChunk,
+		                           const std::array<ComponentType, sizeof...(Ts)>& pTypes, Func& pFunc,
+		                           std::index_sequence<Is...>)
+		{
+			const uint32_t size = pArchetype.GetChunkSize(pChunk);
+			const Entity* entities = pArchetype.GetEntities(pChunk);
+			std::tuple<Ts*...> columns{pArchetype.GetColumn<Ts>(pTypes[Is], pChunk)...};
+
+			for (uint32_t i = 0; i < size; ++i)
+				InvokeQuery(pFunc, entities[i], std::get<Is>(columns)[i]...);
+		}
+	};
+}
@@ -1,67 +1,410 @@
 ﻿#pragma once
-#include <unordered_map>
+#include <atomic>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "Ecs.h"
+#include "SparseSet.h"
 
 namespace Owl::Ecs
 {
+	/**
+	 * \brief What a type erased pool tells about its component type.
+	 */
+	struct ComponentLayout
+	{
+		uint64_t TypeKey = 0;
+		uint32_t Size = 0;
+		uint32_t Alignment = 0;
+		bool IsTriviallyCopyable = false;
+		bool IsTag = false;
+
+		template <typename T>
+		static ComponentLayout Create()
+		{
+			return {GetStableTypeKey<T>(), IsTagComponent<T> ? 0u : sizeof(T), alignof(T), std::is_trivially_copyable_v<T>, IsTagComponent<T>};
+		}
+	};
+
+	/**
+	 * \brief Change ticks of a component slot; a component is newer than a tick when IsNewerTick holds for its stamp.
+	 */
+	struct ComponentTicks
+	{
+		uint32_t Added;
+		uint32_t Changed;
+	};
+
+	class IComponentArray;
+
+	/**
+	 * \brief Bookkeeping of an owned group: the entities owning a component in every one of Pools are kept packed in
+	 * the first Size slots of each pool, in the same order. The pools maintain it when components are inserted
+	 * or removed, so every way of adding and removing components keeps the group packed.
+	 */
+	struct OwnedGroup
+	{
+		Signature Types;
+		std::vector<IComponentArray*> Pools;
+		size_t Size = 0;
+
+		/**
+		 * \brief Moves pEntity into the group if it now owns a component in every pool.
+		 */
+		void EntityInserted(Entity pEntity);
+
+		/**
+		 * \brief Moves pEntity out of the group before one of its components is removed.
+		 */
+		void EntityRemoving(Entity pEntity);
+	};
+
 	class IComponentArray
 	{
 	public:
 		virtual ~IComponentArray() = default;
 		virtual void EntityDestroyed(Entity pEntity) = 0;
+		virtual void Reserve(size_t pCount) = 0;
+
+		[[nodiscard]] virtual ComponentLayout GetLayout() const = 0;
+		[[nodiscard]] virtual size_t GetSize() const = 0;
+		[[nodiscard]] virtual const SparseSet& GetEntities() const = 0;
+
+		/**
+		 * \brief The ticks of every component, in the same order as GetEntities().
+		 */
+		[[nodiscard]] virtual std::span<const ComponentTicks> GetTicks() const = 0;
+		[[nodiscard]] virtual uint32_t GetLastChangeTick() const = 0;
+
+		/**
+		 * \brief The packed components, in the same order as GetEntities().
+		 */
+		[[nodiscard]] virtual const void* GetRawData() const = 0;
+
+		/**
+		 * \brief Appends pEntities with components copied bytewise from pData.
+		 * Only valid when GetLayout().IsTriviallyCopyable.
+		 */
+		virtual void InsertRawData(std::span<const Entity> pEntities, const void* pData) = 0;
+
+		/**
+		 * \brief Exchanges the entities, components and ticks of two dense slots.
+		 */
+		virtual void Swap(size_t pLeft, size_t pRight) = 0;
+
+		/**
+		 * \brief Copies the slots of a double-buffered pool stamped since the previous publish into its read buffer.
+		 * \param pTick Components stamped after it are published by the next call.
+		 */
+		virtual void Publish(uint32_t pTick) = 0;
+
+		/**
+		 * \brief The group owning this pool, or nullptr.
+		 */
+		[[nodiscard]] OwnedGroup* GetGroup() const { return m_Group; }
+		void SetGroup(OwnedGroup* pGroup) { m_Group = pGroup; }
+
+	protected:
+		OwnedGroup* m_Group = nullptr;
 	};
 
+	inline void OwnedGroup::EntityInserted(const Entity pEntity)
+	{
+		const uint32_t index = Pools.front()->GetEntities().Find(pEntity);
+		if (index == SparseSet::k_Invalid || index < Size)
+			return;
+
+		for (const IComponentArray* pool : Pools)
+		{
+			if (!pool->GetEntities().Contains(pEntity))
+				return;
+		}
+
+		for (IComponentArray* pool : Pools)
+			pool->Swap(pool->GetEntities().IndexOf(pEntity), Size);
+		++Size;
+	}
+
+	inline void OwnedGroup::EntityRemoving(const Entity pEntity)
+	{
+		const uint32_t index = Pools.front()->GetEntities().Find(pEntity);
+		if (index == SparseSet::k_Invalid || index >= Size)
+			return;
+
+		--Size;
+		for (IComponentArray* pool : Pools)
+			pool->Swap(pool->GetEntities().IndexOf(pEntity), Size);
+	}
+
+	/**
+	 * \brief Packed storage of one component type. Every slot carries ComponentTicks, stamped with the
+	 * change tick of the world when the component is inserted or obtained mutably.
+	 * A double-buffered pool also keeps a published copy of every component, in the same dense order, that is only
+	 * written by Publish: it can be read from other threads while the components themselves are being written.
+	 * Inserting, removing and swapping slots move the published copy along with the components and may reallocate
+	 * it, so readers must not overlap those structural changes, nor Publish.
+	 */
 	template <typename T>
 	class ComponentArray final : public IComponentArray
 	{
 	public:
+		explicit ComponentArray(const std::atomic<uint32_t>* pChangeTick = nullptr)
+			: m_ChangeTick(pChangeTick)
+		{
+		}
+
 		void InsertData(const Entity pEntity, T pComponent)
 		{
-			OWL_CORE_ASSERT(!m_EntityToIndexMap.contains(pEntity), "Component added to same entity more than once.")
+			OWL_CORE_ASSERT(!m_Entities.Contains(pEntity), "Component added to same entity more than once.")
+
+			const uint32_t tick = Stamp();
+			m_Entities.Insert(pEntity);
+			m_ComponentArray.push_back(std::move(pComponent));
+			m_Ticks.push_back({tick, tick});
+			if (m_IsDoubleBuffered)
+				PublishInserted(1);
 
-			size_t newIndex = m_Size;
-			m_EntityToIndexMap[pEntity] = newIndex;
-			m_IndexToEntityMap[newIndex] = pEntity;
-			m_ComponentArray[newIndex] = pComponent;
-			++m_Size;
+			if (m_Group)
+				m_Group->EntityInserted(pEntity);
+		}
+
+		/**
+		 * \brief Gives every entity of pEntities a copy of pComponent, written contiguously at the end of the pool.
+		 */
+		void InsertData(const std::span<const Entity> pEntities, const T& pComponent)
+		{
+			const uint32_t tick = Stamp();
+			m_Entities.Insert(pEntities);
+			m_ComponentArray.insert(m_ComponentArray.end(), pEntities.size(), pComponent);
+			m_Ticks.insert(m_Ticks.end(), pEntities.size(), {tick, tick});
+			if (m_IsDoubleBuffered)
+				PublishInserted(pEntities.size());
+			GroupInserted(pEntities);
+		}
+
+		/**
+		 * \brief Gives pEntities[i] the component pComponents[i], written contiguously at the end of the pool.
+		 */
+		void InsertData(const std::span<const Entity> pEntities, const std::span<const T> pComponents)
+		{
+			OWL_CORE_ASSERT(pEntities.size() == pComponents.size(), "Entity and component ranges differ in size.")
+
+			const uint32_t tick = Stamp();
+			m_Entities.Insert(pEntities);
+			m_ComponentArray.insert(m_ComponentArray.end(), pComponents.begin(), pComponents.end());
+			m_Ticks.insert(m_Ticks.end(), pEntities.size(), {tick, tick});
+			if (m_IsDoubleBuffered)
+				PublishInserted(pEntities.size());
+			GroupInserted(pEntities);
 		}
 
 		void RemoveData(const Entity pEntity)
 		{
-			OWL_CORE_ASSERT(m_EntityToIndexMap.contains(pEntity), "Removing non-existent component.")
+			OWL_CORE_ASSERT(m_Entities.Contains(pEntity), "Removing non-existent component.")
 
-			size_t indexOfRemovedEntity = m_EntityToIndexMap[pEntity];
-			size_t indexOfLastElement = m_Size - 1;
-			const Entity entityOfLastElement = m_IndexToEntityMap[indexOfLastElement];
+			if (m_Group)
+				m_Group->EntityRemoving(pEntity);
 
-			m_ComponentArray[indexOfRemovedEntity] = m_ComponentArray[indexOfLastElement];
-			m_EntityToIndexMap[entityOfLastElement] = indexOfLastElement;
-			m_IndexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+			const size_t indexOfRemovedEntity = m_Entities.IndexOf(pEntity);
+			const size_t indexOfLastElement = m_Entities.Size() - 1;
 
-			m_EntityToIndexMap.erase(pEntity);
-			m_IndexToEntityMap.erase(indexOfLastElement);
+			if (indexOfRemovedEntity != indexOfLastElement)
+			{
+				m_ComponentArray[indexOfRemovedEntity] = std::move(m_ComponentArray[indexOfLastElement]);
+				m_Ticks[indexOfRemovedEntity] = m_Ticks[indexOfLastElement];
+				if (m_IsDoubleBuffered)
+					m_Published[indexOfRemovedEntity] = std::move(m_Published[indexOfLastElement]);
+			}
+			m_ComponentArray.pop_back();
+			m_Ticks.pop_back();
+			if (m_IsDoubleBuffered)
+				m_Published.pop_back();
 
-			--m_Size;
+			m_Entities.Remove(pEntity);
 		}
 
+		/**
+		 * \brief Mutable access; stamps the component as changed.
+		 */
 		T& GetData(const Entity pEntity)
 		{
-			OWL_CORE_ASSERT(m_EntityToIndexMap.contains(pEntity), "Retrieving non-existent component.")
+			OWL_CORE_ASSERT(m_Entities.Contains(pEntity), "Retrieving non-existent component.")
+
+			const size_t index = m_Entities.IndexOf(pEntity);
+			m_Ticks[index].Changed = Stamp();
+			return m_ComponentArray[index];
+		}
+
+		const T& GetData(const Entity pEntity) const
+		{
+			OWL_CORE_ASSERT(m_Entities.Contains(pEntity), "Retrieving non-existent component.")
+
+			return m_ComponentArray[m_Entities.IndexOf(pEntity)];
+		}
+
+		/**
+		 * \brief The component as of the last Publish of a double-buffered pool.
+		 */
+		const T& GetPublishedData(const Entity pEntity) const
+		{
+			OWL_CORE_ASSERT(m_IsDoubleBuffered, "Reading the published buffer of a pool that is not double-buffered.")
+			OWL_CORE_ASSERT(m_Entities.Contains(pEntity), "Retrieving non-existent component.")
+
+			return m_Published[m_Entities.IndexOf(pEntity)];
+		}
+
+		[[nodiscard]] bool HasData(const Entity pEntity) const { return m_Entities.Contains(pEntity); }
+
+		[[nodiscard]] T* TryGetData(const Entity pEntity)
+		{
+			const uint32_t index = m_Entities.Find(pEntity);
+			if (index == SparseSet::k_Invalid)
+				return nullptr;
+
+			m_Ticks[index].Changed = Stamp();
+			return &m_ComponentArray[index];
+		}
+
+		[[nodiscard]] const T* TryGetData(const Entity pEntity) const
+		{
+			const uint32_t index = m_Entities.Find(pEntity);
+			return index != SparseSet::k_Invalid ? &m_ComponentArray[index] : nullptr;
+		}
+
+		/**
+		 * \brief Raw component storage, in dense order. Writes through it are not stamped; see MarkChanged.
+		 */
+		[[nodiscard]] T* Data() { return m_ComponentArray.data(); }
+		[[nodiscard]] const T* PublishedData() const { return m_Published.data(); }
+		[[nodiscard]] const ComponentTicks& GetTicks(const size_t pIndex) const { return m_Ticks[pIndex]; }
+		[[nodiscard]] std::span<const ComponentTicks> GetTicks() const override { return m_Ticks; }
+		void MarkChanged(const size_t pIndex) { m_Ticks[pIndex].Changed = Stamp(); }
+
+		/**
+		 * \brief The newest tick any slot was stamped with. Nothing in the pool changed after a tick not below it.
+		 */
+		[[nodiscard]] uint32_t GetLastChangeTick() const override { return m_LastChangeTick; }
+		[[nodiscard]] uint32_t GetChangeTick() const { return m_ChangeTick ? m_ChangeTick->load(std::memory_order_relaxed) : 0; }
+		[[nodiscard]] const SparseSet& GetEntities() const override { return m_Entities; }
+		[[nodiscard]] size_t GetSize() const override { return m_ComponentArray.size(); }
+		[[nodiscard]] size_t GetCapacity() const { return m_ComponentArray.capacity(); }
+		[[nodiscard]] ComponentLayout GetLayout() const override { return ComponentLayout::Create<T>(); }
+		[[nodiscard]] const void* GetRawData() const override { return m_ComponentArray.data(); }
+
+		void InsertRawData(const std::span<const Entity> pEntities, const void* pData) override
+		{
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				const T* components = static_cast<const T*>(pData);
+				InsertData(pEntities, std::span<const T>(components, pEntities.size()));
+			}
+			else
+			{
+				OWL_CORE_ASSERT(false, "Bytewise insertion of a component that is not trivially copyable.")
+			}
+		}
+
+		void Swap(const size_t pLeft, const size_t pRight) override
+		{
+			if (pLeft == pRight)
+				return;
+
+			std::swap(m_ComponentArray[pLeft], m_ComponentArray[pRight]);
+			std::swap(m_Ticks[pLeft], m_Ticks[pRight]);
+			if (m_IsDoubleBuffered)
+				std::swap(m_Published[pLeft], m_Published[pRight]);
+			m_Entities.Swap(pLeft, pRight);
+		}
 
-			return m_ComponentArray[m_EntityToIndexMap[pEntity]];
+		/**
+		 * \brief Starts keeping a published copy of every component, initialized with the current values.
+		 */
+		void EnableDoubleBuffering()
+		{
+			if constexpr (std::is_copy_assignable_v<T> && std::is_copy_constructible_v<T>)
+			{
+				m_Published = m_ComponentArray;
+				m_Published.reserve(m_ComponentArray.capacity());
+				// Writes stamped with the current tick after this call still compare newer.
+				m_PublishedTick = GetChangeTick() - 1;
+				m_IsDoubleBuffered = true;
+			}
+			else
+			{
+				OWL_CORE_ASSERT(false, "Double buffering a component that cannot be copied.")
+			}
 		}
 
+		void Publish(const uint32_t pTick) override
+		{
+			if constexpr (std::is_copy_assignable_v<T>)
+			{
+				// Nothing was stamped since the last publish: the buffers already match.
+				if (!m_IsDoubleBuffered || !IsNewerTick(m_LastChangeTick, m_PublishedTick))
+				{
+					m_PublishedTick = pTick;
+					return;
+				}
+
+				for (size_t i = 0; i < m_Ticks.size(); ++i)
+				{
+					if (IsNewerTick(m_Ticks[i].Changed, m_PublishedTick))
+						m_Published[i] = m_ComponentArray[i];
+				}
+				m_PublishedTick = pTick;
+			}
+		}
+
+		[[nodiscard]] bool IsDoubleBuffered() const { return m_IsDoubleBuffered; }
+
 		void EntityDestroyed(const Entity pEntity) override
 		{
-			if (m_EntityToIndexMap.contains(pEntity))
+			if (m_Entities.Contains(pEntity))
 				RemoveData(pEntity);
 		}
 
+		void Reserve(const size_t pCount) override
+		{
+			m_ComponentArray.reserve(pCount);
+			m_Ticks.reserve(pCount);
+			if (m_IsDoubleBuffered)
+				m_Published.reserve(pCount);
+			m_Entities.Reserve(pCount);
+		}
+
 	private:
-		std::array<T, MAX_ENTITIES> m_ComponentArray;
-		std::unordered_map<Entity, size_t> m_EntityToIndexMap;
-		std::unordered_map<size_t, Entity> m_IndexToEntityMap;
-		size_t m_Size = 0;
+		std::vector<T> m_ComponentArray;
+		std::vector<ComponentTicks> m_Ticks;
+		SparseSet m_Entities;
+		std::vector<T> m_Published;
+		const std::atomic<uint32_t>* m_ChangeTick;
+		uint32_t m_LastChangeTick = 0;
+		uint32_t m_PublishedTick = 0;
+		bool m_IsDoubleBuffered = false;
+
+		uint32_t Stamp()
+		{
+			m_LastChangeTick = GetChangeTick();
+			return m_LastChangeTick;
+		}
+
+		// New components are visible in the published buffer right away. This may reallocate it, which is why readers
+		// of the published buffer must not overlap structural changes to the pool.
+		void PublishInserted(const size_t pCount)
+		{
+			if constexpr (std::is_copy_constructible_v<T>)
+				m_Published.insert(m_Published.end(), m_ComponentArray.end() - static_cast<std::ptrdiff_t>(pCount), m_ComponentArray.end());
+		}
+
+		void GroupInserted(const std::span<const Entity> pEntities)
+		{
+			if (m_Group)
+			{
+				for (const Entity entity : pEntities)
+					m_Group->EntityInserted(entity);
+			}
+		}
 	};
 }
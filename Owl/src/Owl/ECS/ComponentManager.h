@@ -1,7 +1,9 @@
 ﻿#pragma once
+#include <array>
+#include <atomic>
 #include <memory>
-#include <ranges>
-#include <unordered_map>
+#include <type_traits>
+#include <vector>
 
 #include "ComponentArray.h"
 #include "Ecs.h"
@@ -11,65 +13,198 @@ namespace Owl::Ecs
 	class ComponentManager
 	{
 	public:
+		/**
+		 * \brief Registers T and creates its pool. Tags get no pool.
+		 */
 		template <typename T>
 		void RegisterComponent()
 		{
-			const char* typeName = typeid(T).name();
+			const ComponentType type = RegisterComponentType<T>();
+			if constexpr (!IsTagComponent<T>)
+				m_ComponentArrays[type] = std::make_unique<ComponentArray<T>>(&m_ChangeTick);
+		}
 
-			OWL_CORE_ASSERT(!m_ComponentTypes.contains(typeName), "Registering component type more than once.");
+		/**
+		 * \brief Gives T the next free type of this world.
+		 * \throws std::length_error when MAX_COMPONENTS types are already registered.
+		 */
+		template <typename T>
+		ComponentType RegisterComponentType()
+		{
+			const uint32_t type = m_LocalTypes.Assure(ComponentTypeIndex::Get<T>(), "Too many component types registered in one world.");
 
-			m_ComponentTypes.insert({typeName, m_NextComponentType});
-			m_ComponentArrays.insert({typeName, std::make_shared<ComponentArray<T>>()});
-			++m_NextComponentType;
+			OWL_CORE_ASSERT(!m_RegisteredTypes.test(type), "Registering component type more than once.");
+
+			m_RegisteredTypes.set(type);
+			m_Layouts[type] = ComponentLayout::Create<T>();
+			m_TagTypes.set(type, IsTagComponent<T>);
+			return static_cast<ComponentType>(type);
 		}
 
 		template <typename T>
-		ComponentType GetComponentType()
+		[[nodiscard]] ComponentType GetComponentType() const
 		{
-			const char* typeName = typeid(T).name();
+			const uint32_t type = m_LocalTypes.Find(ComponentTypeIndex::Get<T>());
 
-			OWL_CORE_ASSERT(m_ComponentTypes.contains(typeName), "Component not registered before use.");
+			OWL_CORE_ASSERT(type != INVALID_COMPONENT_TYPE, "Component not registered before use.");
 
-			return m_ComponentTypes[typeName];
+			return static_cast<ComponentType>(type);
 		}
 
+		/**
+		 * \brief The type a ComponentTypeIndex value is registered as in this world, or INVALID_COMPONENT_TYPE.
+		 */
+		[[nodiscard]] uint32_t FindComponentType(const uint32_t pTypeIndex) const { return m_LocalTypes.Find(pTypeIndex); }
+
 		template <typename T>
 		void AddComponent(Entity pEntity, T pComponent)
 		{
-			GetComponentArray<T>()->InsertData(pEntity, pComponent);
+			GetComponentArray<T>().InsertData(pEntity, std::move(pComponent));
 		}
 
 		template <typename T>
 		void RemoveComponent(Entity pEntity)
 		{
-			GetComponentArray<T>()->RemoveData(pEntity);
+			GetComponentArray<T>().RemoveData(pEntity);
 		}
 
 		template <typename T>
 		T& GetComponent(Entity pEntity)
 		{
-			return GetComponentArray<T>()->GetData(pEntity);
+			return GetComponentArray<T>().GetData(pEntity);
+		}
+
+		template <typename T>
+		void Reserve(const size_t pCount)
+		{
+			GetComponentArray<T>().Reserve(pCount);
 		}
 
 		void EntityDestroyed(const Entity pEntity) const
 		{
-			for (const auto& component : m_ComponentArrays | std::views::values)
-				component->EntityDestroyed(pEntity);
+			for (const auto& component : m_ComponentArrays)
+			{
+				if (component)
+					component->EntityDestroyed(pEntity);
+			}
 		}
 
-	private:
-		std::unordered_map<const char*, ComponentType> m_ComponentTypes{};
-		std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_ComponentArrays{};
-		ComponentType m_NextComponentType{};
+		template <typename T>
+		ComponentArray<T>& GetComponentArray() const
+		{
+			static_assert(!IsTagComponent<T>, "Tag components have no storage; test them with HasComponent or a signature.");
+
+			const ComponentType type = GetComponentType<T>();
+
+			OWL_CORE_ASSERT(m_ComponentArrays[type], "Component has no storage in this world.");
+
+			return static_cast<ComponentArray<T>&>(*m_ComponentArrays[type]);
+		}
+
+		/**
+		 * \brief The pool of pType, or nullptr when the type has no pool.
+		 */
+		[[nodiscard]] IComponentArray* GetComponentArray(const ComponentType pType) const
+		{
+			return m_ComponentArrays[pType].get();
+		}
 
+		/**
+		 * \brief Gives the pool of T a published buffer; see ComponentArray.
+		 */
 		template <typename T>
-		std::shared_ptr<ComponentArray<T>> GetComponentArray()
+		void EnableDoubleBuffering()
 		{
-			const char* typeName = typeid(T).name();
+			static_assert(std::is_copy_assignable_v<T> && std::is_copy_constructible_v<T>, "Double-buffered components are copied when published.");
 
-			OWL_CORE_ASSERT(m_ComponentTypes.contains(typeName), "Component not registered before use.");
+			ComponentArray<T>& pool = GetComponentArray<T>();
+			if (!pool.IsDoubleBuffered())
+			{
+				pool.EnableDoubleBuffering();
+				m_DoubleBufferedTypes.set(GetComponentType<T>());
+			}
+		}
+
+		/**
+		 * \brief Copies what was written to the double-buffered pools since the previous call into their published
+		 * buffers. Only the stamped slots are copied, and pools nothing was stamped in are skipped.
+		 */
+		void PublishDoubleBuffered()
+		{
+			if (m_DoubleBufferedTypes.none())
+				return;
+
+			const uint32_t tick = AdvanceChangeTick();
+			ForEachComponentType(m_DoubleBufferedTypes, [this, tick](const ComponentType pType)
+			{
+				m_ComponentArrays[pType]->Publish(tick);
+			});
+		}
+
+		/**
+		 * \brief The group owning the pools of pTypes, created on first request. Creating it packs the entities that
+		 * already own every one of the components at the front of the pools. A pool is owned by one group at most.
+		 */
+		OwnedGroup& AssureGroup(const Signature pTypes)
+		{
+			for (const auto& group : m_Groups)
+			{
+				if (group->Types == pTypes)
+					return *group;
+			}
+
+			auto group = std::make_unique<OwnedGroup>();
+			group->Types = pTypes;
+			ForEachComponentType(pTypes, [this, &group](const ComponentType pType)
+			{
+				IComponentArray* pool = m_ComponentArrays[pType].get();
+
+				OWL_CORE_ASSERT(pool, "Groups own component pools; tags and unregistered types cannot be grouped.")
+				OWL_CORE_ASSERT(!pool->GetGroup(), "Component pool already owned by another group.")
 
-			return std::static_pointer_cast<ComponentArray<T>>(m_ComponentArrays[typeName]);
+				pool->SetGroup(group.get());
+				group->Pools.push_back(pool);
+			});
+
+			// Joining swaps the entity with the first slot past the group, which was already visited.
+			const SparseSet& entities = group->Pools.front()->GetEntities();
+			for (size_t i = 0; i < entities.Size(); ++i)
+				group->EntityInserted(entities.Data()[i]);
+
+			return *m_Groups.emplace_back(std::move(group));
 		}
+
+		[[nodiscard]] bool IsRegistered(const ComponentType pType) const { return m_RegisteredTypes.test(pType); }
+		[[nodiscard]] uint32_t GetRegisteredCount() const { return m_LocalTypes.GetCount(); }
+		[[nodiscard]] const ComponentLayout& GetLayout(const ComponentType pType) const { return m_Layouts[pType]; }
+
+		/**
+		 * \brief The bits of every registered tag type.
+		 */
+		[[nodiscard]] Signature GetTagTypes() const { return m_TagTypes; }
+
+		/**
+		 * \brief The bits of every type whose pool has a published buffer.
+		 */
+		[[nodiscard]] Signature GetDoubleBufferedTypes() const { return m_DoubleBufferedTypes; }
+
+		[[nodiscard]] uint32_t GetChangeTick() const { return m_ChangeTick.load(std::memory_order_relaxed); }
+
+		/**
+		 * \brief Moves the change tick forward.
+		 * \return The tick before advancing; everything stamped after this call compares newer than it.
+		 */
+		uint32_t AdvanceChangeTick() { return m_ChangeTick.fetch_add(1, std::memory_order_relaxed); }
+
+	private:
+		LocalTypeTable<MAX_COMPONENTS> m_LocalTypes;
+		std::array<std::unique_ptr<IComponentArray>, MAX_COMPONENTS> m_ComponentArrays{};
+		// Starts past zero so a consumer that never ran sees every component as added and changed.
+		std::atomic<uint32_t> m_ChangeTick{1};
+		std::array<ComponentLayout, MAX_COMPONENTS> m_Layouts{};
+		Signature m_RegisteredTypes{};
+		Signature m_TagTypes{};
+		Signature m_DoubleBufferedTypes{};
+		std::vector<std::unique_ptr<OwnedGroup>> m_Groups;
 	};
 }
@@ -0,0 +1,15 @@
+﻿#pragma once
+#include <vector>
+
+#include "Owl/ECS/Ecs.h"
+
+namespace Owl
+{
+	/**
+	 * \brief The direct children of an entity. Managed through TransformSystem::SetParent/RemoveParent.
+	 */
+	struct ChildrenComponent
+	{
+		std::vector<Ecs::Entity> Children;
+	};
+}
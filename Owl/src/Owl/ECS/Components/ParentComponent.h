@@ -0,0 +1,15 @@
+﻿#pragma once
+#include "Owl/ECS/Ecs.h"
+
+namespace Owl
+{
+	/**
+	 * \brief Attaches an entity below another one. Managed through TransformSystem::SetParent/RemoveParent.
+	 */
+	struct ParentComponent
+	{
+		Ecs::Entity Parent = Ecs::NULL_ENTITY;
+		// Distance from the root of the hierarchy; roots have no ParentComponent and sit at depth 0.
+		uint32_t Depth = 1;
+	};
+}
@@ -10,5 +10,13 @@ namespace Owl
 		Vector3 Position{};
 		Vector3 Scale{1.f, 1.f, 1.f};
 		Vector3 Rotation;
+
+		/**
+		 * \brief Scale, then rotation (Euler angles in radians, X then Y then Z), then translation.
+		 */
+		[[nodiscard]] Matrix4 GetLocalMatrix() const
+		{
+			return Matrix4::Scale(Scale) * Matrix4::Euler(Rotation.x, Rotation.y, Rotation.z) * Matrix4::Translation(Position);
+		}
 	};
 }
@@ -0,0 +1,13 @@
+﻿#pragma once
+#include "Owl/Math/Matrix4.h"
+
+namespace Owl
+{
+	/**
+	 * \brief Cached local to world matrix, kept up to date by TransformSystem.
+	 */
+	struct WorldTransformComponent
+	{
+		Matrix4 Matrix = Matrix4::Identity();
+	};
+}
@@ -1,32 +1,187 @@
 ﻿#pragma once
+#include <atomic>
+#include <bit>
 #include <bitset>
-#include <set>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 
 namespace Owl::Ecs
 {
 	class World;
 
+	/**
+	 * \brief Entity handle packing a slot index (low bits) and the generation of that slot (high bits).
+	 * Destroying an entity bumps the generation of its slot, so stale handles never alias a recycled entity.
+	 */
 	using Entity = std::uint32_t;
-	constexpr Entity MAX_ENTITIES = 1000;
+	constexpr uint32_t ENTITY_INDEX_BITS = 20;
+	constexpr Entity ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+	constexpr Entity ENTITY_GENERATION_MASK = ~ENTITY_INDEX_MASK >> ENTITY_INDEX_BITS;
+	constexpr Entity NULL_ENTITY = std::numeric_limits<Entity>::max();
+
+	constexpr uint32_t GetEntityIndex(const Entity pEntity) { return pEntity & ENTITY_INDEX_MASK; }
+	constexpr uint32_t GetEntityGeneration(const Entity pEntity) { return pEntity >> ENTITY_INDEX_BITS; }
+
+	constexpr Entity MakeEntity(const uint32_t pIndex, const uint32_t pGeneration)
+	{
+		return ((pGeneration & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (pIndex & ENTITY_INDEX_MASK);
+	}
 
 	using ComponentType = std::uint8_t;
 	constexpr ComponentType MAX_COMPONENTS = 32;
 
 	using Signature = std::bitset<MAX_COMPONENTS>;
 
-	class System
+	using ResourceType = std::uint8_t;
+	constexpr ResourceType MAX_RESOURCES = 32;
+
+	using ResourceSignature = std::bitset<MAX_RESOURCES>;
+
+	/**
+	 * \brief Empty component types are tags: they only exist as their bit in the entity Signature, so adding and
+	 * removing them updates membership without touching any component storage. Tags cannot be fetched.
+	 */
+	template <typename T>
+	constexpr bool IsTagComponent = std::is_empty_v<T>;
+
+	/**
+	 * \brief Whether pTick was stamped after pSinceTick. Change ticks are compared modulo 2^32, so the result stays
+	 * right when the counter wraps, as long as the two ticks are less than 2^31 ticks apart.
+	 */
+	constexpr bool IsNewerTick(const uint32_t pTick, const uint32_t pSinceTick)
+	{
+		return static_cast<int32_t>(pTick - pSinceTick) > 0;
+	}
+
+	/**
+	 * \brief Calls pFunc(type) for every component type set in pSignature, in ascending order.
+	 */
+	template <typename Func>
+	void ForEachComponentType(const Signature pSignature, Func&& pFunc)
+	{
+		for (uint64_t bits = pSignature.to_ullong(); bits != 0; bits &= bits - 1)
+			pFunc(static_cast<ComponentType>(std::countr_zero(bits)));
+	}
+
+	/**
+	 * \brief Hands out a process-wide index per type, assigned on first use and stable afterward.
+	 * Worlds map it to their own dense types through a LocalTypeTable before indexing signatures with it.
+	 * \tparam Family Separates the index spaces, so components and systems are numbered independently.
+	 */
+	template <typename Family>
+	class TypeIndex
+	{
+	public:
+		template <typename T>
+		static uint32_t Get() { return Index<std::remove_cvref_t<T>>(); }
+
+	private:
+		inline static std::atomic<uint32_t> s_NextIndex{0};
+
+		template <typename T>
+		static uint32_t Index()
+		{
+			static const uint32_t s_Index = s_NextIndex++;
+			return s_Index;
+		}
+	};
+
+	/**
+	 * \brief Maps process-wide TypeIndex values to dense types local to one world, so the capacity of its signatures
+	 * bounds the types that world uses rather than every type the process has seen.
+	 * \tparam Capacity How many local types the table hands out.
+	 */
+	template <uint32_t Capacity>
+	class LocalTypeTable
 	{
 	public:
-		System(World* pWorld)
-			: m_World(pWorld)
+		static_assert(Capacity < std::numeric_limits<uint8_t>::max(), "Local types are stored in a byte.");
+
+		static constexpr uint32_t INVALID_TYPE = std::numeric_limits<uint8_t>::max();
+
+		/**
+		 * \brief The local type of pTypeIndex, or INVALID_TYPE when it has none.
+		 */
+		[[nodiscard]] uint32_t Find(const uint32_t pTypeIndex) const
+		{
+			return pTypeIndex < m_LocalTypes.size() ? m_LocalTypes[pTypeIndex] : INVALID_TYPE;
+		}
+
+		/**
+		 * \brief The local type of pTypeIndex, assigned on first request.
+		 * \throws std::length_error with pError once all Capacity types are taken.
+		 */
+		uint32_t Assure(const uint32_t pTypeIndex, const char* pError)
+		{
+			if (pTypeIndex >= m_LocalTypes.size())
+				m_LocalTypes.resize(pTypeIndex + 1, static_cast<uint8_t>(INVALID_TYPE));
+
+			uint8_t& type = m_LocalTypes[pTypeIndex];
+			if (type == INVALID_TYPE)
+			{
+				if (m_Count == Capacity)
+					throw std::length_error(pError);
+
+				type = static_cast<uint8_t>(m_Count++);
+			}
+			return type;
+		}
+
+		[[nodiscard]] uint32_t GetCount() const { return m_Count; }
+
+	private:
+		std::vector<uint8_t> m_LocalTypes;
+		uint32_t m_Count = 0;
+	};
+
+	constexpr uint32_t INVALID_COMPONENT_TYPE = LocalTypeTable<MAX_COMPONENTS>::INVALID_TYPE;
+	constexpr uint32_t INVALID_RESOURCE_TYPE = LocalTypeTable<MAX_RESOURCES>::INVALID_TYPE;
+
+	/**
+	 * \brief Invokes a query callback, passing the entity first when the callback accepts it.
+	 */
+	template <typename Func, typename... Ts>
+	void InvokeQuery(Func& pFunc, const Entity pEntity, Ts&... pComponents)
+	{
+		if constexpr (std::is_invocable_v<Func&, Entity, Ts&...>)
+			pFunc(pEntity, pComponents...);
+		else
+			pFunc(pComponents...);
+	}
+
+	/**
+	 * \brief A key for T that stays the same across runs and builds as long as T keeps its qualified name,
+	 * unlike TypeIndex. It is an FNV-1a hash of the compiler's signature of this function.
+	 */
+	template <typename T>
+	constexpr uint64_t GetStableTypeKey()
+	{
+#ifdef _MSC_VER
+		constexpr std::string_view signature = __FUNCSIG__;
+#else
+		constexpr std::string_view signature = __PRETTY_FUNCTION__;
+#endif
+		uint64_t hash = 14695981039346656037ull;
+		for (const char character : signature)
 		{
+			hash ^= static_cast<uint8_t>(character);
+			hash *= 1099511628211ull;
 		}
+		return hash;
+	}
 
-		std::set<Entity>& GetEntities() { return m_Entities; }
+	using ComponentTypeIndex = TypeIndex<struct ComponentFamily>;
+	using SystemTypeIndex = TypeIndex<struct SystemFamily>;
+	using ResourceTypeIndex = TypeIndex<struct ResourceFamily>;
 
-	protected:
-		std::set<Entity> m_Entities;
-		World* m_World;
+	enum class StorageMode
+	{
+		ComponentPools,
+		Archetypes
 	};
 }
@@ -0,0 +1,158 @@
+﻿#include "opch.h"
+#include "EcsCommandBuffer.h"
+
+namespace Owl::Ecs
+{
+	void EcsCommandBuffer::Playback(World& pWorld)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		if (!m_IsGrouped)
+			SortCommands();
+
+		// Grow the entity and component storage once for the whole batch instead of command by command.
+		pWorld.m_EntityManager->ReserveAdditional(m_PendingCount);
+		for (const auto& pool : m_Payloads)
+		{
+			if (pool)
+				pool->ReserveStorage(pWorld);
+		}
+
+		m_Resolved.assign(m_PendingCount, NULL_ENTITY);
+
+		const size_t count = m_Commands.size();
+		for (size_t begin = 0; begin < count;)
+			begin = m_Commands[begin].IsPending ? PlaybackPending(pWorld, begin) : PlaybackExisting(pWorld, begin);
+
+		// Stores the components of new entities one type at a time, straight from the payload arrays.
+		for (const auto& pool : m_Payloads)
+		{
+			if (pool)
+				pool->StoreOwned(pWorld, m_Resolved);
+		}
+
+		std::vector<Entity> resolved = std::move(m_Resolved);
+		Clear();
+		m_Resolved = std::move(resolved);
+	}
+
+	Entity EcsCommandBuffer::Resolve(const PendingEntity pEntity) const
+	{
+		OWL_CORE_ASSERT(pEntity.Index < m_Resolved.size(), "Resolving a pending entity that was not played back.")
+
+		return m_Resolved[pEntity.Index];
+	}
+
+	void EcsCommandBuffer::Clear()
+	{
+		m_Commands.clear();
+		for (const auto& pool : m_Payloads)
+		{
+			if (pool)
+				pool->Clear();
+		}
+		m_PendingFlags.clear();
+		m_Resolved.clear();
+		m_PendingCount = 0;
+		m_LastGroupKey = 0;
+		m_IsGrouped = true;
+	}
+
+	void EcsCommandBuffer::SortCommands()
+	{
+		// The recording position in the low bits keeps the commands of each entity in the order they were issued.
+		constexpr uint32_t positionBits = 31;
+		constexpr uint64_t positionMask = (uint64_t{1} << positionBits) - 1;
+
+		const size_t count = m_Commands.size();
+		m_SortKeys.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			m_SortKeys[i] = (GetGroupKey(m_Commands[i].Target, m_Commands[i].IsPending) << positionBits) | i;
+		std::sort(m_SortKeys.begin(), m_SortKeys.end());
+
+		std::vector<Command> sorted;
+		sorted.reserve(count);
+		for (const uint64_t key : m_SortKeys)
+			sorted.push_back(m_Commands[key & positionMask]);
+		m_Commands.swap(sorted);
+	}
+
+	size_t EcsCommandBuffer::PlaybackExisting(World& pWorld, const size_t pBegin)
+	{
+		const size_t count = m_Commands.size();
+		const Command& first = m_Commands[pBegin];
+
+		size_t end = pBegin;
+		bool isDestroyed = false;
+		for (; end < count && IsSameTarget(m_Commands[end], first); ++end)
+			isDestroyed |= m_Commands[end].Type == CommandType::Destroy;
+
+		// Buffers are filled independently, so another playback may already have destroyed the target: every command
+		// recorded for it is dropped, as the slot may be free or reused.
+		if (!pWorld.IsAlive(first.Target))
+			return end;
+
+		// Whatever else was recorded for a destroyed entity is dropped with it.
+		if (isDestroyed)
+		{
+			pWorld.DestroyEntity(first.Target);
+			return end;
+		}
+
+		const Entity entity = first.Target;
+		const Signature oldSignature = pWorld.m_EntityManager->GetSignature(entity);
+		Signature signature = oldSignature;
+		for (size_t i = pBegin; i < end; ++i)
+		{
+			const Command& command = m_Commands[i];
+			command.Apply(pWorld, entity, m_Payloads[command.Component].get(), command.Payload);
+			signature.set(pWorld.m_ComponentManager->FindComponentType(command.Component), command.Type == CommandType::AddComponent);
+		}
+
+		if (signature != oldSignature)
+			pWorld.CommitSignature(entity, oldSignature, signature);
+		return end;
+	}
+
+	size_t EcsCommandBuffer::PlaybackPending(World& pWorld, const size_t pBegin)
+	{
+		const size_t count = m_Commands.size();
+		const Command& first = m_Commands[pBegin];
+		const uint8_t flags = m_PendingFlags[first.Target];
+
+		size_t end = pBegin;
+		if (flags & k_PendingDestroyed)
+		{
+			while (end < count && IsSameTarget(m_Commands[end], first))
+				++end;
+			return end;
+		}
+
+		const Entity entity = pWorld.CreateEntity();
+		m_Resolved[first.Target] = entity;
+
+		// Entities that only receive components leave them to the bulk store at the end of the playback.
+		const bool isDeferred = !(flags & k_PendingRemoves);
+
+		Signature signature;
+		for (; end < count && IsSameTarget(m_Commands[end], first); ++end)
+		{
+			const Command& command = m_Commands[end];
+			if (command.Type == CommandType::Create)
+				continue;
+
+			signature.set(pWorld.m_ComponentManager->FindComponentType(command.Component), command.Type == CommandType::AddComponent);
+			if (isDeferred)
+				continue;
+
+			IPayloadPool* pool = m_Payloads[command.Component].get();
+			command.Apply(pWorld, entity, pool, command.Payload);
+			if (command.Type == CommandType::AddComponent)
+				pool->Owners[command.Payload] = k_Applied;
+		}
+
+		if (signature.any())
+			pWorld.CommitSignature(entity, Signature{}, signature);
+		return end;
+	}
+}
@@ -0,0 +1,258 @@
+﻿#pragma once
+#include <memory>
+#include <vector>
+
+#include "Ecs.h"
+#include "World.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Handle to an entity created through an EcsCommandBuffer, valid until the buffer is played back.
+	 */
+	struct PendingEntity
+	{
+		uint32_t Index;
+	};
+
+	/**
+	 * \brief Records structural changes (create, destroy, add and remove component) to apply later at a sync point.
+	 * Recording never touches the World, so a buffer may be filled during iteration or from a worker thread;
+	 * a single buffer is not thread safe, use one per thread.
+	 * Playback groups the commands per entity, applies them in recording order and commits each entity
+	 * signature, and notifies the systems, once per entity instead of once per command. Commands recorded for an
+	 * entity that is no longer alive at playback, destroyed by another buffer for instance, are dropped.
+	 */
+	class EcsCommandBuffer
+	{
+	public:
+		EcsCommandBuffer() = default;
+		~EcsCommandBuffer() = default;
+
+		EcsCommandBuffer(const EcsCommandBuffer&) = delete;
+		EcsCommandBuffer& operator=(const EcsCommandBuffer&) = delete;
+		EcsCommandBuffer(EcsCommandBuffer&&) = default;
+		EcsCommandBuffer& operator=(EcsCommandBuffer&&) = default;
+
+		PendingEntity CreateEntity()
+		{
+			const PendingEntity entity{m_PendingCount++};
+			m_PendingFlags.push_back(0);
+			Record(CommandType::Create, entity.Index, true);
+			return entity;
+		}
+
+		void DestroyEntity(const Entity pEntity) { Record(CommandType::Destroy, pEntity, false); }
+
+		void DestroyEntity(const PendingEntity pEntity)
+		{
+			m_PendingFlags[pEntity.Index] |= k_PendingDestroyed;
+			Record(CommandType::Destroy, pEntity.Index, true);
+		}
+
+		template <typename T>
+		void AddComponent(const Entity pEntity, T pComponent) { RecordAdd<T>(pEntity, false, std::move(pComponent)); }
+
+		template <typename T>
+		void AddComponent(const PendingEntity pEntity, T pComponent) { RecordAdd<T>(pEntity.Index, true, std::move(pComponent)); }
+
+		template <typename T>
+		void RemoveComponent(const Entity pEntity) { RecordRemove<T>(pEntity, false); }
+
+		template <typename T>
+		void RemoveComponent(const PendingEntity pEntity)
+		{
+			m_PendingFlags[pEntity.Index] |= k_PendingRemoves;
+			RecordRemove<T>(pEntity.Index, true);
+		}
+
+		/**
+		 * \brief Applies every recorded command to pWorld and clears the buffer.
+		 * Pending entities can be resolved with Resolve until the next command is recorded.
+		 */
+		void Playback(World& pWorld);
+
+		/**
+		 * \brief The entity a pending entity became during the last Playback, or NULL_ENTITY if it was destroyed.
+		 */
+		[[nodiscard]] Entity Resolve(PendingEntity pEntity) const;
+
+		/**
+		 * \brief Drops every recorded command without applying it.
+		 */
+		void Clear();
+
+		[[nodiscard]] size_t GetCommandCount() const { return m_Commands.size(); }
+		[[nodiscard]] bool IsEmpty() const { return m_Commands.empty(); }
+
+	private:
+		enum class CommandType : uint8_t
+		{
+			Create,
+			Destroy,
+			AddComponent,
+			RemoveComponent
+		};
+
+		static constexpr uint32_t k_Applied = std::numeric_limits<uint32_t>::max();
+		static constexpr uint8_t k_PendingDestroyed = 1 << 0;
+		static constexpr uint8_t k_PendingRemoves = 1 << 1;
+
+		class IPayloadPool
+		{
+		public:
+			// Per payload, the pending entity it is stored into in bulk after the per-entity pass, or k_Applied.
+			std::vector<uint32_t> Owners;
+
+			virtual ~IPayloadPool() = default;
+			virtual void Clear() = 0;
+			virtual void ReserveStorage(World& pWorld) const = 0;
+			virtual void StoreOwned(World& pWorld, const std::vector<Entity>& pResolved) = 0;
+		};
+
+		template <typename T>
+		class PayloadPool final : public IPayloadPool
+		{
+		public:
+			std::vector<T> Payloads;
+
+			void Clear() override
+			{
+				Payloads.clear();
+				Owners.clear();
+			}
+
+			void ReserveStorage(World& pWorld) const override { EcsCommandBuffer::ReserveStorage<T>(pWorld, Payloads.size()); }
+
+			void StoreOwned(World& pWorld, const std::vector<Entity>& pResolved) override
+			{
+				const ComponentType type = pWorld.GetComponentType<T>();
+				for (size_t i = 0; i < Payloads.size(); ++i)
+				{
+					if (Owners[i] != k_Applied && pResolved[Owners[i]] != NULL_ENTITY)
+						pWorld.StoreComponent<T>(pResolved[Owners[i]], type, std::move(Payloads[i]));
+				}
+			}
+		};
+
+		using ApplyFunction = void (*)(World&, Entity, IPayloadPool*, uint32_t);
+
+		struct Command
+		{
+			uint32_t Target;
+			uint32_t Payload;
+			// The ComponentTypeIndex of the component, as buffers are recorded without a world to resolve it.
+			uint32_t Component;
+			CommandType Type;
+			bool IsPending;
+			ApplyFunction Apply;
+		};
+
+		std::vector<Command> m_Commands;
+		std::vector<uint64_t> m_SortKeys;
+		std::vector<std::unique_ptr<IPayloadPool>> m_Payloads;
+		std::vector<uint8_t> m_PendingFlags;
+		std::vector<Entity> m_Resolved;
+		uint32_t m_PendingCount = 0;
+		uint64_t m_LastGroupKey = 0;
+		bool m_IsGrouped = true;
+
+		// Orders existing entities by slot, then generation, ahead of pending entities in creation order.
+		static uint64_t GetGroupKey(const uint32_t pTarget, const bool pIsPending)
+		{
+			if (pIsPending)
+				return uint64_t{1} << 32 | pTarget;
+
+			return uint64_t{GetEntityIndex(pTarget)} << (32 - ENTITY_INDEX_BITS) | GetEntityGeneration(pTarget);
+		}
+
+		static bool IsSameTarget(const Command& pLeft, const Command& pRight)
+		{
+			return pLeft.Target == pRight.Target && pLeft.IsPending == pRight.IsPending;
+		}
+
+		void SortCommands();
+		size_t PlaybackExisting(World& pWorld, size_t pBegin);
+		size_t PlaybackPending(World& pWorld, size_t pBegin);
+
+		Command& Record(const CommandType pType, const uint32_t pTarget, const bool pIsPending)
+		{
+			if (!m_Resolved.empty())
+				m_Resolved.clear();
+
+			OWL_CORE_ASSERT(m_Commands.size() < uint64_t{1} << 31, "Too many commands recorded in one buffer.")
+
+			// Buffers filled entity by entity are already grouped and skip the sort on playback.
+			const uint64_t groupKey = GetGroupKey(pTarget, pIsPending);
+			m_IsGrouped &= groupKey >= m_LastGroupKey;
+			m_LastGroupKey = groupKey;
+
+			Command& command = m_Commands.emplace_back();
+			command.Target = pTarget;
+			command.Payload = 0;
+			command.Type = pType;
+			command.Component = 0;
+			command.IsPending = pIsPending;
+			command.Apply = nullptr;
+			return command;
+		}
+
+		template <typename T>
+		void RecordAdd(const uint32_t pTarget, const bool pIsPending, T pComponent)
+		{
+			const uint32_t type = ComponentTypeIndex::Get<T>();
+			if (type >= m_Payloads.size())
+				m_Payloads.resize(type + 1);
+
+			auto& pool = m_Payloads[type];
+			if (!pool)
+				pool = std::make_unique<PayloadPool<T>>();
+
+			auto& payloads = static_cast<PayloadPool<T>&>(*pool).Payloads;
+			Command& command = Record(CommandType::AddComponent, pTarget, pIsPending);
+			command.Component = type;
+			command.Payload = static_cast<uint32_t>(payloads.size());
+			command.Apply = &ApplyAdd<T>;
+			payloads.push_back(std::move(pComponent));
+			pool->Owners.push_back(pIsPending ? pTarget : k_Applied);
+		}
+
+		template <typename T>
+		void RecordRemove(const uint32_t pTarget, const bool pIsPending)
+		{
+			Command& command = Record(CommandType::RemoveComponent, pTarget, pIsPending);
+			command.Component = ComponentTypeIndex::Get<T>();
+			command.Apply = &ApplyRemove<T>;
+		}
+
+		template <typename T>
+		static void ReserveStorage(World& pWorld, const size_t pIncoming)
+		{
+			if constexpr (!IsTagComponent<T>)
+			{
+				if (pIncoming == 0 || pWorld.m_StorageMode != StorageMode::ComponentPools)
+					return;
+
+				// Only when the pool would overflow, then at least doubling the capacity, so a stream of small playbacks
+				// grows the pool geometrically instead of copying it every time.
+				const ComponentArray<T>& pool = pWorld.m_ComponentManager->GetComponentArray<T>();
+				const size_t required = pool.GetSize() + pIncoming;
+				if (required > pool.GetCapacity())
+					pWorld.m_ComponentManager->Reserve<T>(std::max(required, pool.GetCapacity() * 2));
+			}
+		}
+
+		template <typename T>
+		static void ApplyAdd(World& pWorld, const Entity pEntity, IPayloadPool* pPool, const uint32_t pPayload)
+		{
+			auto& payloads = static_cast<PayloadPool<T>*>(pPool)->Payloads;
+			pWorld.StoreComponent<T>(pEntity, pWorld.GetComponentType<T>(), std::move(payloads[pPayload]));
+		}
+
+		template <typename T>
+		static void ApplyRemove(World& pWorld, const Entity pEntity, IPayloadPool*, uint32_t)
+		{
+			pWorld.EraseComponent<T>(pEntity, pWorld.GetComponentType<T>());
+		}
+	};
+}
@@ -3,45 +3,110 @@
 
 namespace Owl::Ecs
 {
-	EntityManager::EntityManager()
-		: m_LivingEntityCount(0)
+	EntityManager::EntityManager(const uint32_t pReserveEntities)
+		: m_Handles{NULL_ENTITY}, m_LivingEntityCount(0)
 	{
-		for (Entity entity = 0; entity < MAX_ENTITIES; ++entity)
-			m_AvailableEntities.push(entity);
+		Reserve(pReserveEntities);
 	}
 
 	Entity EntityManager::CreateEntity()
 	{
-		OWL_CORE_ASSERT(m_LivingEntityCount < MAX_ENTITIES, "Too many entities in existence.")
+		Entity entity;
+		if (!m_FreeIndices.empty())
+		{
+			const uint32_t index = m_FreeIndices.back();
+			m_FreeIndices.pop_back();
 
-		const Entity id = m_AvailableEntities.front();
-		m_AvailableEntities.pop();
+			entity = MakeEntity(index, GetEntityGeneration(m_Handles[index]));
+			m_Handles[index] = entity;
+		}
+		else
+		{
+			// The last slot is a sentinel so IsAlive always has a slot to read.
+			const uint32_t index = static_cast<uint32_t>(m_Handles.size()) - 1;
+
+			OWL_CORE_ASSERT(index < ENTITY_INDEX_MASK, "Too many entities in existence.")
+
+			entity = MakeEntity(index, 0);
+			m_Handles.back() = entity;
+			m_Handles.push_back(NULL_ENTITY);
+
+			if (index / k_PageSize >= m_Signatures.size())
+				m_Signatures.push_back(std::make_unique<SignaturePage>());
+		}
 		++m_LivingEntityCount;
 
-		return id;
+		return entity;
+	}
+
+	void EntityManager::CreateEntities(const std::span<Entity> pEntities, const Signature pSignature)
+	{
+		ReserveAdditional(static_cast<uint32_t>(pEntities.size()));
+
+		for (Entity& entity : pEntities)
+		{
+			entity = CreateEntity();
+			GetSignatureSlot(entity) = pSignature;
+		}
 	}
 
-	void EntityManager::DestroyEntity(Entity pEntity)
+	void EntityManager::DestroyEntity(const Entity pEntity)
 	{
-		OWL_CORE_ASSERT(pEntity < MAX_ENTITIES, "Requested to destroy an entity out of range.")
+		OWL_CORE_ASSERT(IsAlive(pEntity), "Requested to destroy an entity that is not alive.")
 
-		m_Signatures[pEntity].reset();
+		GetSignatureSlot(pEntity).reset();
 
-		m_AvailableEntities.push(pEntity);
+		// Dead slots keep the next generation behind an index no handle can carry.
+		const uint32_t index = GetEntityIndex(pEntity);
+		m_Handles[index] = MakeEntity(ENTITY_INDEX_MASK, GetEntityGeneration(pEntity) + 1);
+		m_FreeIndices.push_back(index);
 		--m_LivingEntityCount;
 	}
 
-	void EntityManager::SetSignature(Entity pEntity, Signature pSignature)
+	void EntityManager::SetSignature(const Entity pEntity, const Signature pSignature)
 	{
-		OWL_CORE_ASSERT(pEntity < MAX_ENTITIES, "Requested to set the signature of an entity out of range.")
+		OWL_CORE_ASSERT(IsAlive(pEntity), "Requested to set the signature of an entity that is not alive.")
 
-		m_Signatures[pEntity] = pSignature;
+		GetSignatureSlot(pEntity) = pSignature;
 	}
 
 	Signature EntityManager::GetSignature(const Entity pEntity) const
 	{
-		OWL_CORE_ASSERT(pEntity < MAX_ENTITIES, "Requested to get the signature of an entity out of range.")
+		OWL_CORE_ASSERT(IsAlive(pEntity), "Requested to get the signature of an entity that is not alive.")
+
+		return GetSignatureSlot(pEntity);
+	}
+
+	void EntityManager::Restore(const std::span<const Entity> pHandles, const std::span<const uint32_t> pFreeIndices)
+	{
+		OWL_CORE_ASSERT(m_LivingEntityCount == 0, "Restoring entities over living ones.")
+		OWL_CORE_ASSERT(pFreeIndices.size() <= pHandles.size(), "More free slots than slots.")
+
+		for (const auto& page : m_Signatures)
+			page->fill(Signature());
+
+		m_Handles.assign(pHandles.begin(), pHandles.end());
+		m_Handles.push_back(NULL_ENTITY);
+		m_FreeIndices.assign(pFreeIndices.begin(), pFreeIndices.end());
+		m_LivingEntityCount = static_cast<uint32_t>(pHandles.size() - pFreeIndices.size());
+		Reserve(static_cast<uint32_t>(pHandles.size()));
+	}
+
+	void EntityManager::ReserveAdditional(const uint32_t pCount)
+	{
+		// Freed slots are reused first; m_Handles already counts the sentinel.
+		const size_t freshSlots = pCount > m_FreeIndices.size() ? pCount - m_FreeIndices.size() : 0;
+		const size_t required = m_Handles.size() + freshSlots;
+		if (required > m_Handles.capacity())
+			Reserve(static_cast<uint32_t>(std::max(required, m_Handles.capacity() * 2) - 1));
+	}
+
+	void EntityManager::Reserve(const uint32_t pEntityCount)
+	{
+		m_Handles.reserve(pEntityCount + 1);
 
-		return m_Signatures[pEntity];
+		const size_t pageCount = (pEntityCount + k_PageSize - 1) / k_PageSize;
+		while (m_Signatures.size() < pageCount)
+			m_Signatures.push_back(std::make_unique<SignaturePage>());
 	}
 }
@@ -1,6 +1,8 @@
 ﻿#pragma once
 #include <array>
-#include <queue>
+#include <memory>
+#include <span>
+#include <vector>
 
 #include "Ecs.h"
 
@@ -9,16 +11,64 @@ namespace Owl::Ecs
 	class EntityManager
 	{
 	public:
-		EntityManager();
+		static constexpr size_t k_PageSize = 4096;
+
+		explicit EntityManager(uint32_t pReserveEntities = 0);
 
 		Entity CreateEntity();
+
+		/**
+		 * \brief Fills pEntities with new entities that all start with pSignature, growing the storage once.
+		 */
+		void CreateEntities(std::span<Entity> pEntities, Signature pSignature);
 		void DestroyEntity(Entity pEntity);
 		void SetSignature(Entity pEntity, Signature pSignature);
 		[[nodiscard]] Signature GetSignature(Entity pEntity) const;
 
+		/**
+		 * \brief Checks that pEntity still refers to a living entity, without branching.
+		 * Out of range indices are clamped onto the trailing sentinel slot and rejected by the range test.
+		 */
+		[[nodiscard]] bool IsAlive(const Entity pEntity) const
+		{
+			const uint32_t index = GetEntityIndex(pEntity);
+			const uint32_t sentinel = static_cast<uint32_t>(m_Handles.size()) - 1;
+			return (index < sentinel) & (m_Handles[index < sentinel ? index : sentinel] == pEntity);
+		}
+
+		void Reserve(uint32_t pEntityCount);
+
+		/**
+		 * \brief Makes room for pCount more entities. Grows geometrically, and only when the free and spare slots
+		 * do not suffice, so calling it before every batch stays amortized.
+		 */
+		void ReserveAdditional(uint32_t pCount);
+		[[nodiscard]] uint32_t GetLivingEntityCount() const { return m_LivingEntityCount; }
+
+		/**
+		 * \brief The handle of every slot, living or dead; a dead slot holds the handle its next entity will get.
+		 */
+		[[nodiscard]] std::span<const Entity> GetHandles() const { return {m_Handles.data(), m_Handles.size() - 1}; }
+		[[nodiscard]] std::span<const uint32_t> GetFreeIndices() const { return m_FreeIndices; }
+
+		/**
+		 * \brief Replaces every slot by the given state, as returned by GetHandles and GetFreeIndices.
+		 * Signatures are cleared. Requires no living entities.
+		 */
+		void Restore(std::span<const Entity> pHandles, std::span<const uint32_t> pFreeIndices);
+
 	private:
-		std::queue<Entity> m_AvailableEntities{};
-		std::array<Signature, MAX_ENTITIES> m_Signatures{};
+		using SignaturePage = std::array<Signature, k_PageSize>;
+
+		std::vector<Entity> m_Handles{};
+		std::vector<uint32_t> m_FreeIndices{};
+		std::vector<std::unique_ptr<SignaturePage>> m_Signatures{};
 		uint32_t m_LivingEntityCount;
+
+		[[nodiscard]] Signature& GetSignatureSlot(const Entity pEntity) const
+		{
+			const uint32_t index = GetEntityIndex(pEntity);
+			return (*m_Signatures[index / k_PageSize])[index % k_PageSize];
+		}
 	};
 }
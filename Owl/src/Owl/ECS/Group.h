@@ -0,0 +1,69 @@
+﻿#pragma once
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentArray.h"
+#include "Ecs.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Iterates an owned group: the entities owning all of Ts occupy the same leading slots of every pool,
+	 * so the pools are walked in lockstep by dense index, without probing any sparse array.
+	 * Iteration runs back to front, so the callback may remove components from the current entity.
+	 * Ts may be const qualified to read without stamping.
+	 */
+	template <typename... Ts>
+	class Group
+	{
+	public:
+		static_assert((!IsTagComponent<std::remove_const_t<Ts>> && ...), "Groups own component pools; tags cannot be grouped.");
+
+		explicit Group(const OwnedGroup& pGroup, ComponentArray<std::remove_const_t<Ts>>&... pArrays)
+			: m_Group(&pGroup), m_Arrays{&pArrays...}
+		{
+		}
+
+		template <typename Func>
+		void Each(Func&& pFunc) const
+		{
+			EachPacked(pFunc, std::index_sequence_for<Ts...>{});
+		}
+
+		[[nodiscard]] size_t Size() const { return m_Group->Size; }
+		[[nodiscard]] bool Empty() const { return m_Group->Size == 0; }
+
+		/**
+		 * \brief The grouped entities, in dense order.
+		 */
+		[[nodiscard]] std::span<const Entity> GetEntities() const
+		{
+			return {std::get<0>(m_Arrays)->GetEntities().Data(), m_Group->Size};
+		}
+
+	private:
+		const OwnedGroup* m_Group;
+		std::tuple<ComponentArray<std::remove_const_t<Ts>>*...> m_Arrays;
+
+		template <typename Func, size_t... Is>
+		void EachPacked(Func& pFunc, std::index_sequence<Is...>) const
+		{
+			const Entity* entities = std::get<0>(m_Arrays)->GetEntities().Data();
+
+			for (size_t i = m_Group->Size; i-- > 0;)
+			{
+				(Stamp<Is>(i), ...);
+				InvokeQuery(pFunc, entities[i], static_cast<Ts&>(std::get<Is>(m_Arrays)->Data()[i])...);
+			}
+		}
+
+		template <size_t I>
+		void Stamp(const size_t pIndex) const
+		{
+			if constexpr (!std::is_const_v<std::tuple_element_t<I, std::tuple<Ts...>>>)
+				std::get<I>(m_Arrays)->MarkChanged(pIndex);
+		}
+	};
+}
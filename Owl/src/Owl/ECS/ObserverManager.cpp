@@ -0,0 +1,191 @@
+﻿#include "opch.h"
+#include "ObserverManager.h"
+
+namespace Owl::Ecs
+{
+	ObserverId ObserverManager::AddObserver(const ComponentType pType, const ComponentEvent pEvent, ObserverCallback pCallback,
+	                                        const uint32_t pStartTick)
+	{
+		OWL_CORE_ASSERT(!m_IsFlushing, "Observers cannot be added while they are flushed.")
+
+		const ObserverId id = m_NextId++;
+		m_Observers.push_back({id, pType, pEvent, std::move(pCallback), pStartTick});
+		UpdateObservedTypes();
+		return id;
+	}
+
+	void ObserverManager::RemoveObserver(const ObserverId pId)
+	{
+		OWL_CORE_ASSERT(!m_IsFlushing, "Observers cannot be removed while they are flushed.")
+
+		std::erase_if(m_Observers, [pId](const Observer& pObserver) { return pObserver.Id == pId; });
+		UpdateObservedTypes();
+	}
+
+	void ObserverManager::EntitiesCreated(const std::span<const Entity> pEntities, const Signature pSignature)
+	{
+		ForEachComponentType(pSignature & m_ObservesAdded, [&](const ComponentType pType)
+		{
+			m_Added[pType].Insert(pEntities);
+		});
+	}
+
+	void ObserverManager::EntityDestroyed(const Entity pEntity, const Signature pSignature)
+	{
+		ForEachComponentType(pSignature & (m_ObservesAdded | m_ObservesRemoved), [&](const ComponentType pType)
+		{
+			RecordRemoved(pEntity, pType);
+		});
+	}
+
+	void ObserverManager::EntitySignatureChanged(const Entity pEntity, const Signature pOldSignature, const Signature pNewSignature)
+	{
+		const Signature observed = m_ObservesAdded | m_ObservesRemoved;
+		ForEachComponentType((pNewSignature & ~pOldSignature) & m_ObservesAdded, [&](const ComponentType pType)
+		{
+			RecordAdded(pEntity, pType);
+		});
+		ForEachComponentType((pOldSignature & ~pNewSignature) & observed, [&](const ComponentType pType)
+		{
+			RecordRemoved(pEntity, pType);
+		});
+	}
+
+	void ObserverManager::Flush(ComponentManager& pComponentManager)
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(!m_IsFlushing, "Observers flushed from an observer.")
+
+		m_IsFlushing = true;
+
+		// Everything stamped up to this tick is reported now; stamps made by the observers come after it.
+		const uint32_t sinceTick = m_LastFlushTick;
+		m_LastFlushTick = pComponentManager.AdvanceChangeTick();
+
+		for (ComponentType type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			if (m_Removed[type].Empty())
+				continue;
+
+			m_Batch.assign(m_Removed[type].begin(), m_Removed[type].end());
+			m_Removed[type].Clear();
+			Dispatch(type, ComponentEvent::Removed);
+		}
+
+		// The reported additions are kept until the Set events are read, then cleared.
+		Signature reportedAdded;
+		for (ComponentType type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			if (m_Added[type].Empty())
+				continue;
+
+			std::swap(m_Added[type], m_ReportedAdded[type]);
+			reportedAdded.set(type);
+			m_Batch.assign(m_ReportedAdded[type].begin(), m_ReportedAdded[type].end());
+			Dispatch(type, ComponentEvent::Added);
+		}
+
+		ForEachComponentType(m_ObservesSet, [&](const ComponentType pType)
+		{
+			const IComponentArray* pool = pComponentManager.GetComponentArray(pType);
+			if (!pool || !IsNewerTick(pool->GetLastChangeTick(), sinceTick))
+				return;
+
+			// Only the components this flush reported as added are skipped, so components added while nobody
+			// observed the additions are still reported once written.
+			const std::span<const ComponentTicks> ticks = pool->GetTicks();
+			const Entity* entities = pool->GetEntities().Data();
+			const SparseSet& added = m_ReportedAdded[pType];
+			m_Batch.clear();
+			m_BatchTicks.clear();
+			for (size_t i = 0; i < ticks.size(); ++i)
+			{
+				if (IsNewerTick(ticks[i].Changed, sinceTick) && !IsNewerTick(ticks[i].Changed, m_LastFlushTick) && !added.Contains(entities[i]))
+				{
+					m_Batch.push_back(entities[i]);
+					m_BatchTicks.push_back(ticks[i].Changed);
+				}
+			}
+
+			if (!m_Batch.empty())
+				DispatchSet(pType, sinceTick);
+		});
+
+		ForEachComponentType(reportedAdded, [this](const ComponentType pType)
+		{
+			m_ReportedAdded[pType].Clear();
+		});
+
+		m_IsFlushing = false;
+	}
+
+	void ObserverManager::RecordAdded(const Entity pEntity, const ComponentType pType)
+	{
+		// A component removed and added back within a batch is reported as both, in that order.
+		m_Added[pType].Insert(pEntity);
+	}
+
+	void ObserverManager::RecordRemoved(const Entity pEntity, const ComponentType pType)
+	{
+		// Added observers never saw the component yet, so the pair cancels out.
+		if (SparseSet& added = m_Added[pType]; added.Contains(pEntity))
+			added.Remove(pEntity);
+		else if (m_ObservesRemoved.test(pType) && !m_Removed[pType].Contains(pEntity))
+			m_Removed[pType].Insert(pEntity);
+	}
+
+	void ObserverManager::Dispatch(const ComponentType pType, const ComponentEvent pEvent)
+	{
+		for (const Observer& observer : m_Observers)
+		{
+			if (observer.Type == pType && observer.Event == pEvent)
+				observer.Callback(m_Batch);
+		}
+	}
+
+	void ObserverManager::DispatchSet(const ComponentType pType, const uint32_t pSinceTick)
+	{
+		for (const Observer& observer : m_Observers)
+		{
+			if (observer.Type != pType || observer.Event != ComponentEvent::Set)
+				continue;
+
+			if (!IsNewerTick(observer.StartTick, pSinceTick))
+			{
+				observer.Callback(m_Batch);
+				continue;
+			}
+
+			// Registered since the previous flush: the writes made before the registration are not reported.
+			m_StartedBatch.clear();
+			for (size_t i = 0; i < m_Batch.size(); ++i)
+			{
+				if (IsNewerTick(m_BatchTicks[i], observer.StartTick))
+					m_StartedBatch.push_back(m_Batch[i]);
+			}
+
+			if (!m_StartedBatch.empty())
+				observer.Callback(m_StartedBatch);
+		}
+	}
+
+	void ObserverManager::UpdateObservedTypes()
+	{
+		m_ObservesAdded.reset();
+		m_ObservesRemoved.reset();
+		m_ObservesSet.reset();
+
+		for (const Observer& observer : m_Observers)
+		{
+			switch (observer.Event)
+			{
+			case ComponentEvent::Added: m_ObservesAdded.set(observer.Type);
+				break;
+			case ComponentEvent::Removed: m_ObservesRemoved.set(observer.Type);
+				break;
+			case ComponentEvent::Set: m_ObservesSet.set(observer.Type);
+				break;
+			}
+		}
+	}
+}
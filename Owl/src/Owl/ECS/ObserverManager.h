@@ -0,0 +1,80 @@
+﻿#pragma once
+#include <array>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "ComponentManager.h"
+#include "Ecs.h"
+#include "SparseSet.h"
+
+namespace Owl::Ecs
+{
+	enum class ComponentEvent : uint8_t
+	{
+		Added,
+		Removed,
+		Set
+	};
+
+	using ObserverId = uint32_t;
+	using ObserverCallback = std::function<void(std::span<const Entity>)>;
+
+	/**
+	 * \brief Collects component lifecycle events and hands them to observers in batches at a sync point.
+	 * Between two flushes every entity is reported at most once per component and event, and only the net
+	 * effect survives: a component added and removed again is not reported at all. Events of types nobody
+	 * observes are not recorded.
+	 */
+	class ObserverManager
+	{
+	public:
+		/**
+		 * \brief Registers pCallback for pEvent on pType. Set observers only see the writes stamped after pStartTick.
+		 */
+		ObserverId AddObserver(ComponentType pType, ComponentEvent pEvent, ObserverCallback pCallback, uint32_t pStartTick);
+		void RemoveObserver(ObserverId pId);
+
+		void EntitiesCreated(std::span<const Entity> pEntities, Signature pSignature);
+		void EntityDestroyed(Entity pEntity, Signature pSignature);
+		void EntitySignatureChanged(Entity pEntity, Signature pOldSignature, Signature pNewSignature);
+
+		/**
+		 * \brief Calls the observers with everything recorded since the previous flush: removals first, then
+		 * additions, then changes. Set events are read from the change ticks of the component pools; components
+		 * reported as added by the same flush are not reported as set.
+		 * Events raised by the observers themselves are delivered by the next flush.
+		 */
+		void Flush(ComponentManager& pComponentManager);
+
+	private:
+		struct Observer
+		{
+			ObserverId Id;
+			ComponentType Type;
+			ComponentEvent Event;
+			ObserverCallback Callback;
+			uint32_t StartTick;
+		};
+
+		std::vector<Observer> m_Observers{};
+		std::array<SparseSet, MAX_COMPONENTS> m_Added{};
+		std::array<SparseSet, MAX_COMPONENTS> m_ReportedAdded{};
+		std::array<SparseSet, MAX_COMPONENTS> m_Removed{};
+		Signature m_ObservesAdded{};
+		Signature m_ObservesRemoved{};
+		Signature m_ObservesSet{};
+		std::vector<Entity> m_Batch{};
+		std::vector<uint32_t> m_BatchTicks{};
+		std::vector<Entity> m_StartedBatch{};
+		ObserverId m_NextId = 0;
+		uint32_t m_LastFlushTick = 0;
+		bool m_IsFlushing = false;
+
+		void RecordAdded(Entity pEntity, ComponentType pType);
+		void RecordRemoved(Entity pEntity, ComponentType pType);
+		void Dispatch(ComponentType pType, ComponentEvent pEvent);
+		void DispatchSet(ComponentType pType, uint32_t pSinceTick);
+		void UpdateObservedTypes();
+	};
+}
@@ -0,0 +1,187 @@
+﻿#include "opch.h"
+#include "PoolSorter.h"
+
+#include <algorithm>
+
+#include "Owl/Core/Timer.h"
+
+namespace Owl::Ecs
+{
+	namespace
+	{
+		template <typename Item>
+		bool IsBefore(const Item& pLeft, const Item& pRight)
+		{
+			return pLeft.Key != pRight.Key ? pLeft.Key < pRight.Key : GetEntityIndex(pLeft.Owner) < GetEntityIndex(pRight.Owner);
+		}
+	}
+
+	PoolSorter::PoolSorter(IComponentArray* pPool, KeyFunction pKey)
+		: m_Pool(pPool), m_Key(std::move(pKey))
+	{
+	}
+
+	bool PoolSorter::Run(const float pBudgetMillis)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		const Timer timer;
+		do
+		{
+			switch (m_Phase)
+			{
+			case Phase::Gather:
+				if (Gather(k_StepsPerCheck))
+				{
+					m_Phase = Phase::SortRuns;
+					m_Cursor = 0;
+				}
+				break;
+			case Phase::SortRuns:
+				if (SortRuns(k_StepsPerCheck))
+				{
+					m_Phase = Phase::Merge;
+					m_Width = k_RunLength;
+					m_Buffer.resize(m_Items.size());
+					StartMergePair(0);
+				}
+				break;
+			case Phase::Merge:
+				if (Merge(k_StepsPerCheck))
+				{
+					m_Phase = Phase::Apply;
+					m_Cursor = 0;
+					m_Placed = 0;
+					m_MirrorsPlaced.assign(m_Mirrors.size(), 0);
+				}
+				break;
+			case Phase::Apply:
+				if (Apply(k_ApplyStepsPerCheck))
+				{
+					Restart();
+					return true;
+				}
+				break;
+			}
+		}
+		while (timer.ElapsedMillis() < pBudgetMillis);
+
+		return false;
+	}
+
+	void PoolSorter::Restart()
+	{
+		m_Phase = Phase::Gather;
+		m_Items.clear();
+		m_Cursor = 0;
+	}
+
+	void PoolSorter::AddMirror(IComponentArray* pMirror)
+	{
+		OWL_CORE_ASSERT(pMirror && pMirror != m_Pool, "Mirroring a pool onto itself or a type without a pool.")
+		OWL_CORE_ASSERT(!pMirror->GetGroup(), "Pools owned by a group keep the order of their group and cannot mirror another pool.")
+
+		m_Mirrors.push_back(pMirror);
+	}
+
+	size_t PoolSorter::GetSortedCount() const
+	{
+		const OwnedGroup* group = m_Pool->GetGroup();
+		return group ? group->Size : m_Pool->GetSize();
+	}
+
+	bool PoolSorter::Gather(const size_t pSteps)
+	{
+		// Entities added since the pass started are left out of it.
+		const Entity* entities = m_Pool->GetEntities().Data();
+		const size_t end = std::min(GetSortedCount(), m_Cursor + pSteps);
+		for (; m_Cursor < end; ++m_Cursor)
+			m_Items.push_back({m_Key(entities[m_Cursor], m_Cursor), entities[m_Cursor]});
+
+		return m_Cursor >= GetSortedCount();
+	}
+
+	bool PoolSorter::SortRuns(const size_t pSteps)
+	{
+		const size_t end = std::min(m_Items.size(), m_Cursor + pSteps);
+		for (; m_Cursor < end; m_Cursor += k_RunLength)
+		{
+			const auto first = m_Items.begin() + static_cast<std::ptrdiff_t>(m_Cursor);
+			const auto last = m_Items.begin() + static_cast<std::ptrdiff_t>(std::min(m_Items.size(), m_Cursor + k_RunLength));
+			std::sort(first, last, IsBefore<Item>);
+		}
+
+		return m_Cursor >= m_Items.size();
+	}
+
+	void PoolSorter::StartMergePair(const size_t pLeft)
+	{
+		m_Left = pLeft;
+		m_First = pLeft;
+		m_Second = std::min(pLeft + m_Width, m_Items.size());
+		m_Output = pLeft;
+	}
+
+	bool PoolSorter::Merge(size_t pSteps)
+	{
+		// Bottom-up merge sort, resumable after any item.
+		const size_t count = m_Items.size();
+		while (m_Width < count && pSteps-- > 0)
+		{
+			const size_t middle = std::min(m_Left + m_Width, count);
+			const size_t right = std::min(m_Left + 2 * m_Width, count);
+
+			if (m_First < middle && (m_Second >= right || !IsBefore(m_Items[m_Second], m_Items[m_First])))
+				m_Buffer[m_Output++] = m_Items[m_First++];
+			else
+				m_Buffer[m_Output++] = m_Items[m_Second++];
+
+			if (m_Output < right)
+				continue;
+
+			if (right < count)
+				StartMergePair(right);
+			else
+			{
+				m_Items.swap(m_Buffer);
+				m_Width *= 2;
+				StartMergePair(0);
+			}
+		}
+
+		return m_Width >= count;
+	}
+
+	bool PoolSorter::Apply(const size_t pSteps)
+	{
+		// Each entity is swapped into the first slot not yet in place. Entities removed or moved out of the
+		// sorted range since their key was gathered are skipped.
+		const size_t end = std::min(m_Items.size(), m_Cursor + pSteps);
+		for (; m_Cursor < end; ++m_Cursor)
+		{
+			const Entity entity = m_Items[m_Cursor].Owner;
+
+			const uint32_t index = m_Pool->GetEntities().Find(entity);
+			if (index != SparseSet::k_Invalid && index >= m_Placed && index < GetSortedCount())
+			{
+				if (OwnedGroup* group = m_Pool->GetGroup())
+				{
+					for (IComponentArray* pool : group->Pools)
+						pool->Swap(index, m_Placed);
+				}
+				else
+					m_Pool->Swap(index, m_Placed);
+				++m_Placed;
+			}
+
+			for (size_t i = 0; i < m_Mirrors.size(); ++i)
+			{
+				const uint32_t mirrorIndex = m_Mirrors[i]->GetEntities().Find(entity);
+				if (mirrorIndex != SparseSet::k_Invalid && mirrorIndex >= m_MirrorsPlaced[i])
+					m_Mirrors[i]->Swap(mirrorIndex, m_MirrorsPlaced[i]++);
+			}
+		}
+
+		return m_Cursor >= m_Items.size();
+	}
+}
@@ -0,0 +1,117 @@
+﻿#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "ComponentArray.h"
+#include "Ecs.h"
+#include "World.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Incrementally reorders a component pool by a user key, ascending, so iteration follows an access pattern
+	 * that swap-and-pop removal scatters, such as spatial locality or parents before children. Mirrored pools are
+	 * reordered to follow the same entity order. Each Run spends a time budget and resumes where the previous one
+	 * stopped: keys are gathered, merge sorted, then the pools are permuted by swaps, which carry the change ticks
+	 * and published buffers along with the components.
+	 * Sorting a pool owned by a group sorts the group, in lockstep across its pools. Run permutes pools, so call it
+	 * where structural changes are allowed. Changes made between two runs never corrupt a pool; they only leave its
+	 * order imperfect until the next pass. Requires StorageMode::ComponentPools.
+	 */
+	class PoolSorter
+	{
+	public:
+		using KeyFunction = std::function<uint64_t(Entity pEntity, size_t pIndex)>;
+
+		/**
+		 * \brief Sorts the pool of T by pKey(entity, component), which returns an unsigned integer key.
+		 */
+		template <typename T, typename Func>
+		static PoolSorter Create(const World& pWorld, Func pKey)
+		{
+			OWL_CORE_ASSERT(pWorld.GetStorageMode() == StorageMode::ComponentPools, "Sorting requires component pool storage.")
+
+			const ComponentArray<T>& pool = pWorld.m_ComponentManager->GetComponentArray<T>();
+			return PoolSorter(pWorld.m_ComponentManager->GetComponentArray(pWorld.GetComponentType<T>()),
+			                  [&pool, key = std::move(pKey)](const Entity pEntity, const size_t pIndex)
+			                  {
+				                  return static_cast<uint64_t>(key(pEntity, static_cast<const T*>(pool.GetRawData())[pIndex]));
+			                  });
+		}
+
+		/**
+		 * \brief Makes the pools of Ts follow the entity order of the sorted pool. They cannot be owned by a group.
+		 */
+		template <typename... Ts>
+		PoolSorter& Mirror(const World& pWorld)
+		{
+			(AddMirror(pWorld.m_ComponentManager->GetComponentArray(pWorld.GetComponentType<Ts>())), ...);
+			return *this;
+		}
+
+		/**
+		 * \brief Advances the pass for about pBudgetMillis.
+		 * \return True if the pass completed during this call; the next call starts a new pass with fresh keys.
+		 */
+		bool Run(float pBudgetMillis);
+
+		/**
+		 * \brief Drops the progress of the current pass.
+		 */
+		void Restart();
+
+	private:
+		enum class Phase
+		{
+			Gather,
+			SortRuns,
+			Merge,
+			Apply
+		};
+
+		struct Item
+		{
+			uint64_t Key;
+			Entity Owner;
+		};
+
+		static constexpr size_t k_RunLength = 32;
+		static constexpr size_t k_StepsPerCheck = 1024;
+		// An Apply step swaps whole components in the pool and in every grouped or mirrored pool, so the budget is
+		// checked more often there.
+		static constexpr size_t k_ApplyStepsPerCheck = 64;
+
+		IComponentArray* m_Pool;
+		KeyFunction m_Key;
+		std::vector<IComponentArray*> m_Mirrors;
+
+		Phase m_Phase = Phase::Gather;
+		std::vector<Item> m_Items;
+		std::vector<Item> m_Buffer;
+		size_t m_Cursor = 0;
+
+		// Merge: the two runs of m_Width items starting at m_Left are merged into m_Buffer; m_First and m_Second
+		// walk the runs and m_Output the buffer.
+		size_t m_Width = 0;
+		size_t m_Left = 0;
+		size_t m_First = 0;
+		size_t m_Second = 0;
+		size_t m_Output = 0;
+
+		// Apply: how many entities are in place at the front of the pool and of each mirror.
+		size_t m_Placed = 0;
+		std::vector<size_t> m_MirrorsPlaced;
+
+		PoolSorter(IComponentArray* pPool, KeyFunction pKey);
+
+		void AddMirror(IComponentArray* pMirror);
+		[[nodiscard]] size_t GetSortedCount() const;
+
+		bool Gather(size_t pSteps);
+		bool SortRuns(size_t pSteps);
+		bool Merge(size_t pSteps);
+		bool Apply(size_t pSteps);
+		void StartMergePair(size_t pLeft);
+	};
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "World.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief A template entity: a set of component prototypes whose types and signature are resolved once,
+	 * when the prefab is built. World::Instantiate copies the prototypes into new entities in bulk.
+	 * Prototypes are immutable and shared between copies of the prefab. Tags only contribute their signature bit.
+	 */
+	class Prefab
+	{
+	public:
+		explicit Prefab(const World& pWorld)
+			: m_World(&pWorld)
+		{
+		}
+
+		template <typename T>
+		Prefab& Add(T pComponent)
+		{
+			const ComponentType type = m_World->GetComponentType<T>();
+
+			OWL_CORE_ASSERT(!m_Signature.test(type), "Component added to the same prefab more than once.")
+
+			m_Signature.set(type);
+			if constexpr (!IsTagComponent<T>)
+				m_Components.push_back({type, std::make_shared<const T>(std::move(pComponent)), &InsertCopies<T>, &ConstructCopy<T>});
+			return *this;
+		}
+
+		[[nodiscard]] Signature GetSignature() const { return m_Signature; }
+
+	private:
+		friend class World;
+
+		struct Component
+		{
+			ComponentType Type;
+			std::shared_ptr<const void> Prototype;
+			void (*InsertCopies)(IComponentArray& pArray, std::span<const Entity> pEntities, const void* pPrototype);
+			void (*ConstructCopy)(void* pDestination, const void* pPrototype);
+		};
+
+		const World* m_World;
+		Signature m_Signature;
+		std::vector<Component> m_Components;
+
+		template <typename T>
+		static void InsertCopies(IComponentArray& pArray, const std::span<const Entity> pEntities, const void* pPrototype)
+		{
+			static_cast<ComponentArray<T>&>(pArray).InsertData(pEntities, *static_cast<const T*>(pPrototype));
+		}
+
+		template <typename T>
+		static void ConstructCopy(void* pDestination, const void* pPrototype)
+		{
+			new(pDestination) T(*static_cast<const T*>(pPrototype));
+		}
+	};
+}
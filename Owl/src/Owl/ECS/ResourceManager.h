@@ -0,0 +1,120 @@
+﻿#pragma once
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "Ecs.h"
+
+namespace Owl::Ecs
+{
+	class IResource
+	{
+	public:
+		virtual ~IResource() = default;
+	};
+
+	template <typename T>
+	class Resource final : public IResource
+	{
+	public:
+		template <typename... Args>
+		explicit Resource(Args&&... pArgs)
+			: Value(std::forward<Args>(pArgs)...)
+		{
+		}
+
+		T Value;
+	};
+
+	/**
+	 * \brief Cached address of a world resource. Resources are never moved once inserted, so the handle
+	 * stays valid for the lifetime of the World and dereferencing it costs a single load.
+	 */
+	template <typename T>
+	class ResourceHandle
+	{
+	public:
+		ResourceHandle() = default;
+
+		explicit ResourceHandle(T* pResource)
+			: m_Resource(pResource)
+		{
+		}
+
+		[[nodiscard]] bool IsValid() const { return m_Resource != nullptr; }
+
+		T& Get() const
+		{
+			OWL_CORE_ASSERT(m_Resource, "Dereferencing an empty resource handle.")
+
+			return *m_Resource;
+		}
+
+		T& operator*() const { return Get(); }
+		T* operator->() const { return &Get(); }
+
+	private:
+		T* m_Resource = nullptr;
+	};
+
+	/**
+	 * \brief Holds one instance of each resource type, indexed by a per-world type mapped from ResourceTypeIndex.
+	 * Inserting is not synchronized and must not happen while systems update.
+	 */
+	class ResourceManager
+	{
+	public:
+		template <typename T>
+		T& InsertResource(T pValue)
+		{
+			return EmplaceResource<T>(std::move(pValue));
+		}
+
+		/**
+		 * \throws std::length_error when MAX_RESOURCES types are already inserted.
+		 */
+		template <typename T, typename... Args>
+		T& EmplaceResource(Args&&... pArgs)
+		{
+			const uint32_t type = m_LocalTypes.Assure(ResourceTypeIndex::Get<T>(), "Too many resource types inserted in one world.");
+
+			OWL_CORE_ASSERT(!m_Resources[type], "Inserting resource more than once.")
+
+			auto resource = std::make_unique<Resource<T>>(std::forward<Args>(pArgs)...);
+			T& value = resource->Value;
+			m_Resources[type] = std::move(resource);
+			return value;
+		}
+
+		template <typename T>
+		[[nodiscard]] T* TryGetResource() const
+		{
+			const uint32_t type = m_LocalTypes.Find(ResourceTypeIndex::Get<T>());
+			if (type == INVALID_RESOURCE_TYPE)
+				return nullptr;
+
+			IResource* resource = m_Resources[type].get();
+			return resource ? &static_cast<Resource<T>*>(resource)->Value : nullptr;
+		}
+
+		template <typename T>
+		[[nodiscard]] T& GetResource() const
+		{
+			T* resource = TryGetResource<T>();
+
+			OWL_CORE_ASSERT(resource, "Retrieving non-existent resource.")
+
+			return *resource;
+		}
+
+		/**
+		 * \brief The type a ResourceTypeIndex value was inserted as in this world, or INVALID_RESOURCE_TYPE.
+		 */
+		[[nodiscard]] uint32_t FindResourceType(const uint32_t pTypeIndex) const { return m_LocalTypes.Find(pTypeIndex); }
+		[[nodiscard]] uint32_t GetInsertedCount() const { return m_LocalTypes.GetCount(); }
+
+	private:
+		LocalTypeTable<MAX_RESOURCES> m_LocalTypes;
+		std::array<std::unique_ptr<IResource>, MAX_RESOURCES> m_Resources{};
+	};
+}
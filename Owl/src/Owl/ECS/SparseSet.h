@@ -0,0 +1,157 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Ecs.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Maps entities to dense indices through a paged sparse array keyed by entity index.
+	 * Pages are allocated on demand, so lookups are two array loads and removal is a swap-and-pop.
+	 * The dense array keeps full handles, so a stale generation is never reported as contained.
+	 */
+	class SparseSet
+	{
+	public:
+		static constexpr size_t k_PageSize = 4096;
+		static constexpr uint32_t k_Invalid = UINT32_MAX;
+
+		size_t Insert(const Entity pEntity)
+		{
+			OWL_CORE_ASSERT(!Contains(pEntity), "Entity inserted in sparse set more than once.")
+
+			const size_t index = m_Dense.size();
+			const uint32_t entityIndex = GetEntityIndex(pEntity);
+			Assure(entityIndex / k_PageSize)[entityIndex % k_PageSize] = static_cast<uint32_t>(index);
+			m_Dense.push_back(pEntity);
+			return index;
+		}
+
+		/**
+		 * \brief Appends pEntities in order, growing the dense array at most once, geometrically.
+		 */
+		void Insert(const std::span<const Entity> pEntities)
+		{
+			if (const size_t required = m_Dense.size() + pEntities.size(); required > m_Dense.capacity())
+				m_Dense.reserve(std::max(required, m_Dense.capacity() * 2));
+			for (const Entity entity : pEntities)
+				Insert(entity);
+		}
+
+		void Remove(const Entity pEntity)
+		{
+			OWL_CORE_ASSERT(Contains(pEntity), "Removing entity missing from sparse set.")
+
+			uint32_t& index = GetSlot(pEntity);
+			const Entity last = m_Dense.back();
+
+			m_Dense[index] = last;
+			GetSlot(last) = index;
+			index = k_Invalid;
+			m_Dense.pop_back();
+		}
+
+		[[nodiscard]] bool Contains(const Entity pEntity) const
+		{
+			return Find(pEntity) != k_Invalid;
+		}
+
+		/**
+		 * \brief Looks up the dense index of pEntity.
+		 * \return The dense index, or k_Invalid when the entity is not in the set.
+		 */
+		[[nodiscard]] uint32_t Find(const Entity pEntity) const
+		{
+			const uint32_t entityIndex = GetEntityIndex(pEntity);
+			const size_t page = entityIndex / k_PageSize;
+			if (page >= m_Pages.size() || !m_Pages[page])
+				return k_Invalid;
+
+			const uint32_t index = (*m_Pages[page])[entityIndex % k_PageSize];
+			return index != k_Invalid && m_Dense[index] == pEntity ? index : k_Invalid;
+		}
+
+		[[nodiscard]] size_t IndexOf(const Entity pEntity) const
+		{
+			OWL_CORE_ASSERT(Contains(pEntity), "Retrieving entity missing from sparse set.")
+
+			return GetSlot(pEntity);
+		}
+
+		/**
+		 * \brief Exchanges the entities at two dense indices.
+		 */
+		void Swap(const size_t pLeft, const size_t pRight)
+		{
+			std::swap(m_Dense[pLeft], m_Dense[pRight]);
+			GetSlot(m_Dense[pLeft]) = static_cast<uint32_t>(pLeft);
+			GetSlot(m_Dense[pRight]) = static_cast<uint32_t>(pRight);
+		}
+
+		void Reserve(const size_t pCount)
+		{
+			m_Dense.reserve(pCount);
+		}
+
+		/**
+		 * \brief Reorders the dense array by entity index, so iteration follows slot order.
+		 */
+		void Sort()
+		{
+			Sort([](const Entity pLeft, const Entity pRight) { return GetEntityIndex(pLeft) < GetEntityIndex(pRight); });
+		}
+
+		template <typename Compare>
+		void Sort(Compare pCompare)
+		{
+			std::sort(m_Dense.begin(), m_Dense.end(), pCompare);
+			for (size_t index = 0; index < m_Dense.size(); ++index)
+				GetSlot(m_Dense[index]) = static_cast<uint32_t>(index);
+		}
+
+		void Clear()
+		{
+			for (const Entity entity : m_Dense)
+				GetSlot(entity) = k_Invalid;
+			m_Dense.clear();
+		}
+
+		[[nodiscard]] size_t Size() const { return m_Dense.size(); }
+		[[nodiscard]] bool Empty() const { return m_Dense.empty(); }
+		[[nodiscard]] const Entity* Data() const { return m_Dense.data(); }
+
+		[[nodiscard]] std::vector<Entity>::const_iterator begin() const { return m_Dense.begin(); }
+		[[nodiscard]] std::vector<Entity>::const_iterator end() const { return m_Dense.end(); }
+
+	private:
+		using Page = std::array<uint32_t, k_PageSize>;
+
+		std::vector<std::unique_ptr<Page>> m_Pages{};
+		std::vector<Entity> m_Dense{};
+
+		[[nodiscard]] uint32_t& GetSlot(const Entity pEntity) const
+		{
+			const uint32_t entityIndex = GetEntityIndex(pEntity);
+			return (*m_Pages[entityIndex / k_PageSize])[entityIndex % k_PageSize];
+		}
+
+		Page& Assure(const size_t pPage)
+		{
+			if (pPage >= m_Pages.size())
+				m_Pages.resize(pPage + 1);
+
+			if (!m_Pages[pPage])
+			{
+				m_Pages[pPage] = std::make_unique<Page>();
+				m_Pages[pPage]->fill(k_Invalid);
+			}
+
+			return *m_Pages[pPage];
+		}
+	};
+}
@@ -0,0 +1,133 @@
+﻿#pragma once
+#include <vector>
+
+#include "Ecs.h"
+#include "SparseSet.h"
+#include "Owl/Core/Timestep.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief The components and world resources a system reads and writes during OnUpdate, as types of its world.
+	 * A system that never declares its access is treated as touching everything.
+	 */
+	struct SystemAccess
+	{
+		Signature Reads{};
+		Signature Writes{};
+		// Read through their published buffer only; that buffer is not written during Update, so these conflict with nothing.
+		Signature PublishedReads{};
+		ResourceSignature ResourceReads{};
+		ResourceSignature ResourceWrites{};
+		bool IsDeclared = false;
+
+		[[nodiscard]] bool ConflictsWith(const SystemAccess& pOther) const
+		{
+			if (!IsDeclared || !pOther.IsDeclared)
+				return true;
+
+			return (Writes & (pOther.Reads | pOther.Writes)).any() || (pOther.Writes & Reads).any() ||
+				(ResourceWrites & (pOther.ResourceReads | pOther.ResourceWrites)).any() || (pOther.ResourceWrites & ResourceReads).any();
+		}
+	};
+
+	class System
+	{
+	public:
+		System(World* pWorld)
+			: m_World(pWorld)
+		{
+		}
+
+		virtual ~System() = default;
+
+		/**
+		 * \brief Called once per World::Update. Systems whose declared access does not conflict may run concurrently.
+		 */
+		virtual void OnUpdate(Timestep)
+		{
+		}
+
+		/**
+		 * \brief The entities matching the system signature, packed contiguously.
+		 * Insertion and removal are O(1) and reorder the set; call Sort() for slot order iteration.
+		 */
+		SparseSet& GetEntities() { return m_Entities; }
+
+		/**
+		 * \brief The declared access, resolved against the world by the scheduler on the first Update.
+		 */
+		[[nodiscard]] const SystemAccess& GetAccess() const { return m_Access; }
+
+		/**
+		 * \brief The change tick at which OnUpdate last finished; pass it to World::View to filter on Added/Changed.
+		 */
+		[[nodiscard]] uint32_t GetLastUpdateTick() const { return m_LastUpdateTick; }
+
+	protected:
+		SparseSet m_Entities;
+		World* m_World;
+
+		/**
+		 * \brief Declares components read or written in OnUpdate. Call from the constructor, before the first World::Update.
+		 */
+		template <typename... Ts>
+		void Reads()
+		{
+			(m_DeclaredReads.push_back(ComponentTypeIndex::Get<Ts>()), ...);
+			m_Access.IsDeclared = true;
+		}
+
+		template <typename... Ts>
+		void Writes()
+		{
+			(m_DeclaredWrites.push_back(ComponentTypeIndex::Get<Ts>()), ...);
+			m_Access.IsDeclared = true;
+		}
+
+		/**
+		 * \brief Declares double-buffered components only read through their published buffer, with
+		 * World::GetPreviousComponent or Previous<T>. The buffer is not written during Update, so this conflicts
+		 * with no other system, as long as no system adds or removes Ts directly during Update; defer those
+		 * structural changes to an EcsCommandBuffer played back after it. Each of Ts must be double-buffered by the
+		 * time its access is resolved.
+		 */
+		template <typename... Ts>
+		void ReadsPublished()
+		{
+			static_assert(sizeof...(Ts) > 0, "ReadsPublished needs the double-buffered components it reads.");
+
+			(m_DeclaredPublishedReads.push_back(ComponentTypeIndex::Get<Ts>()), ...);
+			m_Access.IsDeclared = true;
+		}
+
+		/**
+		 * \brief Declares world resources read or written in OnUpdate, like Reads and Writes do for components.
+		 */
+		template <typename... Ts>
+		void ReadsResources()
+		{
+			(m_DeclaredResourceReads.push_back(ResourceTypeIndex::Get<Ts>()), ...);
+			m_Access.IsDeclared = true;
+		}
+
+		template <typename... Ts>
+		void WritesResources()
+		{
+			(m_DeclaredResourceWrites.push_back(ResourceTypeIndex::Get<Ts>()), ...);
+			m_Access.IsDeclared = true;
+		}
+
+	private:
+		friend class SystemScheduler;
+
+		// Declared types by ComponentTypeIndex and ResourceTypeIndex, as the world may not have registered them yet.
+		std::vector<uint32_t> m_DeclaredReads;
+		std::vector<uint32_t> m_DeclaredWrites;
+		std::vector<uint32_t> m_DeclaredPublishedReads;
+		std::vector<uint32_t> m_DeclaredResourceReads;
+		std::vector<uint32_t> m_DeclaredResourceWrites;
+		SystemAccess m_Access;
+		uint32_t m_LastUpdateTick = 0;
+	};
+}
@@ -1,28 +1,82 @@
 ﻿#include "opch.h"
 #include "SystemManager.h"
 
-#include <ranges>
-
 namespace Owl::Ecs
 {
-	void SystemManager::EntityDestroyed(const Entity pEntity)
+	void SystemManager::EntityDestroyed(const Entity pEntity, const Signature pEntitySignature)
 	{
-		for (const auto& system : m_Systems | std::views::values)
-			system->GetEntities().erase(pEntity);
+		++m_VisitMark;
+		ForEachComponentType(pEntitySignature, [&](const ComponentType pType)
+		{
+			for (const uint32_t system : m_SystemsByComponent[pType])
+			{
+				if (m_VisitMarks[system] == m_VisitMark)
+					continue;
+				m_VisitMarks[system] = m_VisitMark;
+
+				auto& entities = m_Systems[system]->GetEntities();
+				if (entities.Contains(pEntity))
+					entities.Remove(pEntity);
+			}
+		});
 	}
 
-	void SystemManager::EntitySignatureChanged(const Entity pEntity, const Signature pEntitySignature)
+	void SystemManager::EntitiesCreated(const std::span<const Entity> pEntities, const Signature pSignature)
 	{
-		for (const auto& pair : m_Systems)
+		++m_VisitMark;
+		ForEachComponentType(pSignature, [&](const ComponentType pType)
+		{
+			for (const uint32_t system : m_SystemsByComponent[pType])
+			{
+				if (m_VisitMarks[system] == m_VisitMark)
+					continue;
+				m_VisitMarks[system] = m_VisitMark;
+
+				const Signature& systemSignature = m_Signatures[system];
+				if ((pSignature & systemSignature) == systemSignature)
+					m_Systems[system]->GetEntities().Insert(pEntities);
+			}
+		});
+	}
+
+	void SystemManager::EntitySignatureChanged(const Entity pEntity, const Signature pOldSignature,
+	                                           const Signature pNewSignature)
+	{
+		++m_VisitMark;
+		ForEachComponentType(pOldSignature ^ pNewSignature, [&](const ComponentType pType)
+		{
+			for (const uint32_t system : m_SystemsByComponent[pType])
+			{
+				if (m_VisitMarks[system] == m_VisitMark)
+					continue;
+				m_VisitMarks[system] = m_VisitMark;
+
+				const Signature& systemSignature = m_Signatures[system];
+				const bool matchedBefore = (pOldSignature & systemSignature) == systemSignature;
+				const bool matchesNow = (pNewSignature & systemSignature) == systemSignature;
+				if (matchedBefore == matchesNow)
+					continue;
+
+				if (matchesNow)
+					m_Systems[system]->GetEntities().Insert(pEntity);
+				else
+					m_Systems[system]->GetEntities().Remove(pEntity);
+			}
+		});
+	}
+
+	void SystemManager::SetSignature(const uint32_t pSystemType, const Signature pSignature)
+	{
+		ForEachComponentType(m_Signatures[pSystemType], [&](const ComponentType pType)
+		{
+			std::erase(m_SystemsByComponent[pType], pSystemType);
+		});
+
+		m_Signatures[pSystemType] = pSignature;
+
+		ForEachComponentType(pSignature, [&](const ComponentType pType)
 		{
-			const auto& type = pair.first;
-			const auto& system = pair.second;
-			const auto& systemSignature = m_Signatures[type];
-
-			if ((pEntitySignature & systemSignature) == systemSignature)
-				system->GetEntities().insert(pEntity);
-			else
-				system->GetEntities().erase(pEntity);
-		}
+			m_SystemsByComponent[pType].push_back(pSystemType);
+		});
 	}
 }
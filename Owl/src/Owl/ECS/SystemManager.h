@@ -1,8 +1,14 @@
 ﻿#pragma once
+#include <array>
 #include <memory>
-#include <unordered_map>
+#include <span>
+#include <vector>
 
+#include "ComponentManager.h"
 #include "Ecs.h"
+#include "ResourceManager.h"
+#include "System.h"
+#include "SystemScheduler.h"
 
 namespace Owl::Ecs
 {
@@ -12,30 +18,65 @@ namespace Owl::Ecs
 		template <typename T>
 		std::shared_ptr<T> RegisterSystem(World* pWorld)
 		{
-			const char* typeName = typeid(T).name();
+			const uint32_t type = SystemTypeIndex::Get<T>();
+			if (type >= m_Systems.size())
+			{
+				m_Systems.resize(type + 1);
+				m_Signatures.resize(type + 1);
+				m_VisitMarks.resize(type + 1);
+			}
 
-			OWL_CORE_ASSERT(!m_Systems.contains(typeName), "Registering system more than once.")
+			OWL_CORE_ASSERT(!m_Systems[type], "Registering system more than once.")
 
 			auto system = std::make_shared<T>(pWorld);
-			m_Systems.insert({typeName, system});
+			m_Systems[type] = system;
+			m_UpdateOrder.push_back(system.get());
+			m_Scheduler.Invalidate();
 			return system;
 		}
 
 		template <typename T>
 		void SetSignature(Signature pSignature)
 		{
-			const char* typeName = typeid(T).name();
+			const uint32_t type = SystemTypeIndex::Get<T>();
 
-			OWL_CORE_ASSERT(m_Systems.contains(typeName), "System used before registered.")
+			OWL_CORE_ASSERT(type < m_Systems.size() && m_Systems[type], "System used before registered.")
 
-			m_Signatures.insert({typeName, pSignature});
+			SetSignature(type, pSignature);
 		}
 
-		void EntityDestroyed(Entity pEntity);
-		void EntitySignatureChanged(Entity pEntity, Signature pEntitySignature);
+		/**
+		 * \brief Runs OnUpdate of every system, concurrently where their declared access allows.
+		 * The outcome matches running them one after another in registration order.
+		 */
+		void Update(const Timestep pTimestep, ComponentManager& pComponentManager, const ResourceManager& pResourceManager)
+		{
+			m_Scheduler.Run(m_UpdateOrder, pTimestep, pComponentManager, pResourceManager);
+		}
+
+		void EntityDestroyed(Entity pEntity, Signature pEntitySignature);
+
+		/**
+		 * \brief Adds entities created together with pSignature to every matching system, visiting each system once.
+		 */
+		void EntitiesCreated(std::span<const Entity> pEntities, Signature pSignature);
+
+		/**
+		 * \brief Updates system membership after an entity signature changed.
+		 * Only systems indexed under a changed component are visited, and only those whose
+		 * match result actually flips touch their entity set. Systems with an empty signature match nothing.
+		 */
+		void EntitySignatureChanged(Entity pEntity, Signature pOldSignature, Signature pNewSignature);
 
 	private:
-		std::unordered_map<const char*, Signature> m_Signatures{};
-		std::unordered_map<const char*, std::shared_ptr<System>> m_Systems{};
+		std::vector<Signature> m_Signatures{};
+		std::vector<std::shared_ptr<System>> m_Systems{};
+		std::array<std::vector<uint32_t>, MAX_COMPONENTS> m_SystemsByComponent{};
+		std::vector<uint32_t> m_VisitMarks{};
+		uint32_t m_VisitMark = 0;
+		std::vector<System*> m_UpdateOrder{};
+		SystemScheduler m_Scheduler{};
+
+		void SetSignature(uint32_t pSystemType, Signature pSignature);
 	};
 }
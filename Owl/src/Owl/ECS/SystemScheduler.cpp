@@ -0,0 +1,138 @@
+﻿#include "opch.h"
+#include "SystemScheduler.h"
+
+namespace Owl::Ecs
+{
+	namespace
+	{
+		// Declared components the world has not registered cannot be touched, so they conflict with nothing.
+		Signature ResolveComponents(const ComponentManager& pComponentManager, const std::vector<uint32_t>& pTypeIndices)
+		{
+			Signature signature;
+			for (const uint32_t typeIndex : pTypeIndices)
+			{
+				if (const uint32_t type = pComponentManager.FindComponentType(typeIndex); type != INVALID_COMPONENT_TYPE)
+					signature.set(type);
+			}
+			return signature;
+		}
+
+		ResourceSignature ResolveResources(const ResourceManager& pResourceManager, const std::vector<uint32_t>& pTypeIndices)
+		{
+			ResourceSignature signature;
+			for (const uint32_t typeIndex : pTypeIndices)
+			{
+				if (const uint32_t type = pResourceManager.FindResourceType(typeIndex); type != INVALID_RESOURCE_TYPE)
+					signature.set(type);
+			}
+			return signature;
+		}
+	}
+
+	SystemScheduler::SystemScheduler(const uint32_t pWorkerCount)
+		: m_WorkerCount(pWorkerCount)
+	{
+	}
+
+	void SystemScheduler::Run(const std::vector<System*>& pSystems, const Timestep pTimestep, ComponentManager& pComponentManager,
+	                          const ResourceManager& pResourceManager)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		if (pSystems.empty())
+			return;
+
+		m_ComponentManager = &pComponentManager;
+
+		if (m_IsDirty || m_Nodes.size() != pSystems.size() || m_ComponentTypeCount != pComponentManager.GetRegisteredCount() ||
+			m_ResourceTypeCount != pResourceManager.GetInsertedCount())
+			Build(pSystems, pResourceManager);
+
+		if (!m_ThreadPool)
+			m_ThreadPool = CreateScope<ThreadPool>(m_WorkerCount);
+
+		const auto count = static_cast<uint32_t>(pSystems.size());
+		for (uint32_t node = 0; node < count; ++node)
+			m_PendingPredecessors[node].store(m_Nodes[node].PredecessorCount, std::memory_order_relaxed);
+		m_RemainingNodes.store(count, std::memory_order_release);
+
+		for (uint32_t node = 0; node < count; ++node)
+		{
+			if (m_Nodes[node].PredecessorCount == 0)
+				m_ThreadPool->Submit([this, &pSystems, node, pTimestep] { Execute(pSystems, node, pTimestep); });
+		}
+
+		std::unique_lock lock(m_DoneMutex);
+		m_DoneCondition.wait(lock, [this] { return m_RemainingNodes.load(std::memory_order_acquire) == 0; });
+
+		if (m_Exception)
+			std::rethrow_exception(std::exchange(m_Exception, nullptr));
+	}
+
+	void SystemScheduler::Build(const std::vector<System*>& pSystems, const ResourceManager& pResourceManager)
+	{
+		for (System* system : pSystems)
+		{
+			system->m_Access.Reads = ResolveComponents(*m_ComponentManager, system->m_DeclaredReads);
+			system->m_Access.Writes = ResolveComponents(*m_ComponentManager, system->m_DeclaredWrites);
+			system->m_Access.PublishedReads = ResolveComponents(*m_ComponentManager, system->m_DeclaredPublishedReads);
+			OWL_CORE_ASSERT((system->m_Access.PublishedReads & ~m_ComponentManager->GetDoubleBufferedTypes()).none(),
+			                "A system reads the published buffer of a component that is not double-buffered.")
+			system->m_Access.ResourceReads = ResolveResources(pResourceManager, system->m_DeclaredResourceReads);
+			system->m_Access.ResourceWrites = ResolveResources(pResourceManager, system->m_DeclaredResourceWrites);
+		}
+		m_ComponentTypeCount = m_ComponentManager->GetRegisteredCount();
+		m_ResourceTypeCount = pResourceManager.GetInsertedCount();
+
+		const auto count = static_cast<uint32_t>(pSystems.size());
+		m_Nodes.assign(count, {});
+		m_PendingPredecessors = std::vector<std::atomic<uint32_t>>(count);
+
+		for (uint32_t later = 0; later < count; ++later)
+		{
+			for (uint32_t earlier = 0; earlier < later; ++earlier)
+			{
+				if (!pSystems[earlier]->GetAccess().ConflictsWith(pSystems[later]->GetAccess()))
+					continue;
+
+				m_Nodes[earlier].Successors.push_back(later);
+				++m_Nodes[later].PredecessorCount;
+			}
+		}
+
+		m_IsDirty = false;
+	}
+
+	void SystemScheduler::Execute(const std::vector<System*>& pSystems, const uint32_t pNode, const Timestep pTimestep)
+	{
+		System& system = *pSystems[pNode];
+
+		// A throwing system still finishes its node, or Run would wait forever; the first exception is rethrown there.
+		try
+		{
+			system.OnUpdate(pTimestep);
+		}
+		catch (...)
+		{
+			std::lock_guard lock(m_DoneMutex);
+			if (!m_Exception)
+				m_Exception = std::current_exception();
+		}
+
+		// Systems that may touch what this one reads run strictly before or after it, so every change it has
+		// not seen yet is stamped after this tick. Its own writes are not.
+		system.m_LastUpdateTick = m_ComponentManager->AdvanceChangeTick();
+
+		for (const uint32_t successor : m_Nodes[pNode].Successors)
+		{
+			if (m_PendingPredecessors[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				m_ThreadPool->Submit([this, &pSystems, successor, pTimestep] { Execute(pSystems, successor, pTimestep); });
+		}
+
+		if (m_RemainingNodes.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard lock(m_DoneMutex);
+			m_DoneCondition.notify_all();
+		}
+	}
+}
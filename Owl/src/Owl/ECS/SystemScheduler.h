@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "ComponentManager.h"
+#include "ResourceManager.h"
+#include "System.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/ThreadPool.h"
+#include "Owl/Core/Timestep.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Runs systems on a worker pool while preserving the result of running them in registration order.
+	 * A system depends on every earlier system whose access conflicts with its own; independent systems run concurrently.
+	 */
+	class SystemScheduler
+	{
+	public:
+		explicit SystemScheduler(uint32_t pWorkerCount = 0);
+
+		/**
+		 * \brief Marks the dependency graph for rebuild, after systems were added or changed their access.
+		 * Registering components or inserting resources also rebuilds it, as declared access is resolved against them.
+		 */
+		void Invalidate() { m_IsDirty = true; }
+
+		/**
+		 * \brief Updates pSystems, then records on each system the change tick it finished at.
+		 * \throws The first exception thrown by a system, once every system has run.
+		 */
+		void Run(const std::vector<System*>& pSystems, Timestep pTimestep, ComponentManager& pComponentManager,
+		         const ResourceManager& pResourceManager);
+
+	private:
+		struct Node
+		{
+			std::vector<uint32_t> Successors;
+			uint32_t PredecessorCount = 0;
+		};
+
+		uint32_t m_WorkerCount;
+		bool m_IsDirty = true;
+		uint32_t m_ComponentTypeCount = 0;
+		uint32_t m_ResourceTypeCount = 0;
+
+		std::vector<Node> m_Nodes;
+		std::vector<std::atomic<uint32_t>> m_PendingPredecessors;
+		std::atomic<uint32_t> m_RemainingNodes{0};
+		std::mutex m_DoneMutex;
+		std::condition_variable m_DoneCondition;
+		std::exception_ptr m_Exception;
+		ComponentManager* m_ComponentManager = nullptr;
+
+		// Declared last so the workers are joined before the state they signal through is destroyed.
+		Scope<ThreadPool> m_ThreadPool;
+
+		void Build(const std::vector<System*>& pSystems, const ResourceManager& pResourceManager);
+		void Execute(const std::vector<System*>& pSystems, uint32_t pNode, Timestep pTimestep);
+	};
+}
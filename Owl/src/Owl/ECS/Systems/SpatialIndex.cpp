@@ -0,0 +1,273 @@
+﻿#include "opch.h"
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace Owl::Ecs
+{
+	SpatialIndex::SpatialIndex(World& pWorld, const float pCellSize)
+		: m_World(&pWorld), m_CellSize(pCellSize), m_InverseCellSize(1.f / pCellSize)
+	{
+		OWL_CORE_ASSERT(pCellSize > 0.f, "Spatial index cell size must be positive.")
+		OWL_CORE_ASSERT(pWorld.GetStorageMode() == StorageMode::ComponentPools, "The spatial index requires component pool storage.")
+
+		pWorld.View<const TransformComponent>().Each([this](const Entity pEntity, const TransformComponent& pTransform)
+		{
+			Insert(pEntity, pTransform.Position);
+		});
+
+		m_Observers[0] = pWorld.Observe<TransformComponent>(ComponentEvent::Removed, [this](const std::span<const Entity> pEntities)
+		{
+			for (const Entity entity : pEntities)
+				Erase(entity);
+		});
+		m_Observers[1] = pWorld.Observe<TransformComponent>(ComponentEvent::Added, [this](const std::span<const Entity> pEntities)
+		{
+			const World& world = *m_World;
+			for (const Entity entity : pEntities)
+				Insert(entity, world.GetComponent<TransformComponent>(entity).Position);
+		});
+		m_Observers[2] = pWorld.Observe<TransformComponent>(ComponentEvent::Set, [this](const std::span<const Entity> pEntities)
+		{
+			const World& world = *m_World;
+			for (const Entity entity : pEntities)
+				Move(entity, world.GetComponent<TransformComponent>(entity).Position);
+		});
+	}
+
+	SpatialIndex::~SpatialIndex()
+	{
+		for (const ObserverId observer : m_Observers)
+			m_World->RemoveObserver(observer);
+	}
+
+	void SpatialIndex::QueryNearest(const Vector3& pPoint, const uint32_t pCount, std::vector<Entity>& pResult) const
+	{
+		OWL_PROFILE_FUNCTION();
+
+		pResult.clear();
+		if (pCount == 0 || m_Entities.Empty())
+			return;
+
+		// Max heap of the best candidates so far, keyed by squared distance.
+		std::vector<std::pair<float, Entity>> best;
+		best.reserve(pCount + 1);
+
+		const CellCoordinates center = GetCellCoordinates(pPoint);
+		const int32_t lastShell = std::max({center.X - m_MinCell.X, m_MaxCell.X - center.X, center.Y - m_MinCell.Y,
+		                                    m_MaxCell.Y - center.Y, center.Z - m_MinCell.Z, m_MaxCell.Z - center.Z});
+
+		for (int32_t shell = 0; shell <= lastShell; ++shell)
+		{
+			for (int32_t x = center.X - shell; x <= center.X + shell; ++x)
+			{
+				for (int32_t y = center.Y - shell; y <= center.Y + shell; ++y)
+				{
+					// Inner cells of the shell were visited by the previous ones; only its two faces along z are new.
+					const bool isInner = std::abs(x - center.X) != shell && std::abs(y - center.Y) != shell;
+					const int32_t step = isInner ? std::max(2 * shell, 1) : 1;
+					for (int32_t z = center.Z - shell; z <= center.Z + shell; z += step)
+					{
+						const std::vector<Entry>* cell = FindCell({x, y, z});
+						if (!cell)
+							continue;
+
+						for (const Entry& entry : *cell)
+						{
+							const float distance = (entry.Position - pPoint).LenghtSquared();
+							if (best.size() == pCount && distance >= best.front().first)
+								continue;
+
+							best.emplace_back(distance, entry.Owner);
+							std::push_heap(best.begin(), best.end());
+							if (best.size() > pCount)
+							{
+								std::pop_heap(best.begin(), best.end());
+								best.pop_back();
+							}
+						}
+					}
+				}
+			}
+
+			// Every cell outside the visited shells is at least this far from the point.
+			const float reach = static_cast<float>(shell) * m_CellSize;
+			if (best.size() == pCount && best.front().first <= reach * reach)
+				break;
+		}
+
+		std::sort_heap(best.begin(), best.end());
+		pResult.reserve(best.size());
+		for (const auto& [distance, entity] : best)
+			pResult.push_back(entity);
+	}
+
+	bool SpatialIndex::Raycast(const Vector3& pOrigin, const Vector3& pDirection, const float pMaxDistance, const float pRadius,
+	                           RaycastHit& pHit) const
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(pRadius >= 0.f && pRadius <= m_CellSize, "Raycast radius must be between zero and the cell size.")
+
+		const float length = pDirection.Lenght();
+		if (m_Entities.Empty() || length == 0.f || pMaxDistance <= 0.f)
+			return false;
+
+		const Vector3 direction = pDirection.Normalized();
+		const float origin[3] = {pOrigin.x, pOrigin.y, pOrigin.z};
+		const float step[3] = {direction.x, direction.y, direction.z};
+		const int32_t minCell[3] = {m_MinCell.X - 1, m_MinCell.Y - 1, m_MinCell.Z - 1};
+		const int32_t maxCell[3] = {m_MaxCell.X + 1, m_MaxCell.Y + 1, m_MaxCell.Z + 1};
+
+		// Amanatides-Woo traversal of the cells along the ray.
+		CellCoordinates coordinates = GetCellCoordinates(pOrigin);
+		int32_t* cell[3] = {&coordinates.X, &coordinates.Y, &coordinates.Z};
+		int32_t cellStep[3];
+		float nextBoundary[3];
+		float boundaryDelta[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			cellStep[axis] = step[axis] > 0.f ? 1 : -1;
+			if (step[axis] == 0.f)
+			{
+				nextBoundary[axis] = std::numeric_limits<float>::infinity();
+				boundaryDelta[axis] = std::numeric_limits<float>::infinity();
+				continue;
+			}
+
+			const float boundary = static_cast<float>(*cell[axis] + (step[axis] > 0.f ? 1 : 0)) * m_CellSize;
+			nextBoundary[axis] = (boundary - origin[axis]) / step[axis];
+			boundaryDelta[axis] = m_CellSize / std::abs(step[axis]);
+		}
+
+		// A sphere touching the ray has its center within one cell of a traversed cell, at most a cell further along.
+		const int32_t reach = pRadius > 0.f ? 1 : 0;
+		const float radiusSquared = pRadius * pRadius;
+		pHit = {NULL_ENTITY, pMaxDistance};
+		float cellEntry = 0.f;
+		while (cellEntry <= std::min(pHit.Distance + m_CellSize, pMaxDistance + m_CellSize))
+		{
+			bool isLeaving = false;
+			for (int axis = 0; axis < 3; ++axis)
+				isLeaving |= (*cell[axis] < minCell[axis] && cellStep[axis] < 0) || (*cell[axis] > maxCell[axis] && cellStep[axis] > 0);
+			if (isLeaving)
+				break;
+
+			for (int32_t x = coordinates.X - reach; x <= coordinates.X + reach; ++x)
+			{
+				for (int32_t y = coordinates.Y - reach; y <= coordinates.Y + reach; ++y)
+				{
+					for (int32_t z = coordinates.Z - reach; z <= coordinates.Z + reach; ++z)
+					{
+						const std::vector<Entry>* entries = FindCell({x, y, z});
+						if (!entries)
+							continue;
+
+						for (const Entry& entry : *entries)
+						{
+							const Vector3 toCenter = entry.Position - pOrigin;
+							const float along = toCenter.Dot(direction);
+							const float missSquared = toCenter.LenghtSquared() - along * along;
+							if (missSquared > radiusSquared)
+								continue;
+
+							const float halfChord = std::sqrt(radiusSquared - missSquared);
+							const float distance = along - halfChord >= 0.f ? along - halfChord : along + halfChord >= 0.f ? 0.f : -1.f;
+							if (distance >= 0.f && distance <= pHit.Distance && (pHit.Target == NULL_ENTITY || distance < pHit.Distance))
+								pHit = {entry.Owner, distance};
+						}
+					}
+				}
+			}
+
+			const int axis = nextBoundary[0] < nextBoundary[1] ? (nextBoundary[0] < nextBoundary[2] ? 0 : 2) : (nextBoundary[1] < nextBoundary[2] ? 1 : 2);
+			cellEntry = nextBoundary[axis];
+			nextBoundary[axis] += boundaryDelta[axis];
+			*cell[axis] += cellStep[axis];
+		}
+
+		return pHit.Target != NULL_ENTITY;
+	}
+
+	void SpatialIndex::Insert(const Entity pEntity, const Vector3& pPosition)
+	{
+		const CellCoordinates coordinates = GetCellCoordinates(pPosition);
+		if (m_Entities.Empty())
+		{
+			m_MinCell = coordinates;
+			m_MaxCell = coordinates;
+		}
+
+		m_Entities.Insert(pEntity);
+		m_Locations.emplace_back();
+		AddToCell(GetCellKey(coordinates), coordinates, pEntity, pPosition, m_Locations.back());
+	}
+
+	void SpatialIndex::Erase(const Entity pEntity)
+	{
+		const uint32_t index = m_Entities.Find(pEntity);
+		if (index == SparseSet::k_Invalid)
+			return;
+
+		RemoveFromCell(m_Locations[index]);
+
+		// Mirror the swap-and-pop of the sparse set.
+		m_Locations[index] = m_Locations.back();
+		m_Locations.pop_back();
+		m_Entities.Remove(pEntity);
+	}
+
+	void SpatialIndex::Move(const Entity pEntity, const Vector3& pPosition)
+	{
+		const uint32_t index = m_Entities.Find(pEntity);
+		if (index == SparseSet::k_Invalid)
+		{
+			Insert(pEntity, pPosition);
+			return;
+		}
+
+		Location& location = m_Locations[index];
+		const CellCoordinates coordinates = GetCellCoordinates(pPosition);
+		const uint64_t cell = GetCellKey(coordinates);
+		if (cell == location.Cell)
+		{
+			m_Cells.find(cell)->second[location.Index].Position = pPosition;
+			return;
+		}
+
+		RemoveFromCell(location);
+		AddToCell(cell, coordinates, pEntity, pPosition, location);
+	}
+
+	void SpatialIndex::AddToCell(const uint64_t pCell, const CellCoordinates& pCoordinates, const Entity pEntity, const Vector3& pPosition,
+	                             Location& pLocation)
+	{
+		std::vector<Entry>& entries = m_Cells[pCell];
+		pLocation = {pCell, static_cast<uint32_t>(entries.size())};
+		entries.push_back({pPosition, pEntity});
+
+		// Bounds only grow; they limit how far nearest and ray queries search.
+		m_MinCell = {std::min(m_MinCell.X, pCoordinates.X), std::min(m_MinCell.Y, pCoordinates.Y), std::min(m_MinCell.Z, pCoordinates.Z)};
+		m_MaxCell = {std::max(m_MaxCell.X, pCoordinates.X), std::max(m_MaxCell.Y, pCoordinates.Y), std::max(m_MaxCell.Z, pCoordinates.Z)};
+	}
+
+	void SpatialIndex::RemoveFromCell(const Location& pLocation)
+	{
+		const auto cell = m_Cells.find(pLocation.Cell);
+		std::vector<Entry>& entries = cell->second;
+
+		if (pLocation.Index != entries.size() - 1)
+		{
+			entries[pLocation.Index] = entries.back();
+			m_Locations[m_Entities.IndexOf(entries[pLocation.Index].Owner)].Index = pLocation.Index;
+		}
+		entries.pop_back();
+
+		if (entries.empty())
+			m_Cells.erase(cell);
+	}
+}
@@ -0,0 +1,174 @@
+﻿#pragma once
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "Owl/ECS/ObserverManager.h"
+#include "Owl/ECS/SparseSet.h"
+#include "Owl/Math/Vector3.h"
+
+namespace Owl::Ecs
+{
+	struct RaycastHit
+	{
+		Entity Target = NULL_ENTITY;
+		float Distance = 0.f;
+	};
+
+	/**
+	 * \brief Uniform hash grid over the TransformComponent position of every entity that has one. That position is
+	 * local: it is the world position only for entities without a ParentComponent, so query results are only
+	 * meaningful for root transforms. Children are indexed at their offset from their parent.
+	 * The grid follows the Added, Removed and Set observers of TransformComponent, so it is only modified when
+	 * the world flushes its observers, one batch per frame, and moving an entity touches nothing but its own
+	 * entry. Between two flushes the grid is frame stable: queries are const and can run from any number of
+	 * threads without locking. Systems querying it from a world resource declare ReadsResources<SpatialIndex>().
+	 * Requires StorageMode::ComponentPools and TransformComponent to be registered.
+	 */
+	class SpatialIndex
+	{
+	public:
+		/**
+		 * \param pCellSize Edge length of a grid cell; about the typical query radius works best.
+		 */
+		SpatialIndex(World& pWorld, float pCellSize);
+		~SpatialIndex();
+
+		SpatialIndex(const SpatialIndex&) = delete;
+		SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+		/**
+		 * \brief Calls pFunc(entity, position) for every entity inside the axis aligned box [pMin, pMax].
+		 */
+		template <typename Func>
+		void QueryBox(const Vector3& pMin, const Vector3& pMax, Func&& pFunc) const
+		{
+			if (m_Entities.Empty())
+				return;
+
+			// Cells outside the occupied bounds are empty, so a large box does not walk the space around them.
+			const CellCoordinates min = GetCellCoordinates(pMin);
+			const CellCoordinates max = GetCellCoordinates(pMax);
+			const CellCoordinates first{std::max(min.X, m_MinCell.X), std::max(min.Y, m_MinCell.Y), std::max(min.Z, m_MinCell.Z)};
+			const CellCoordinates last{std::min(max.X, m_MaxCell.X), std::min(max.Y, m_MaxCell.Y), std::min(max.Z, m_MaxCell.Z)};
+			for (int32_t x = first.X; x <= last.X; ++x)
+			{
+				for (int32_t y = first.Y; y <= last.Y; ++y)
+				{
+					for (int32_t z = first.Z; z <= last.Z; ++z)
+					{
+						const std::vector<Entry>* cell = FindCell({x, y, z});
+						if (!cell)
+							continue;
+
+						for (const Entry& entry : *cell)
+						{
+							const Vector3& position = entry.Position;
+							if (position.x >= pMin.x && position.y >= pMin.y && position.z >= pMin.z &&
+								position.x <= pMax.x && position.y <= pMax.y && position.z <= pMax.z)
+								pFunc(entry.Owner, position);
+						}
+					}
+				}
+			}
+		}
+
+		/**
+		 * \brief Calls pFunc(entity, position) for every entity within pRadius of pCenter.
+		 */
+		template <typename Func>
+		void QueryRadius(const Vector3& pCenter, const float pRadius, Func&& pFunc) const
+		{
+			const Vector3 extent(pRadius, pRadius, pRadius);
+			const float radiusSquared = pRadius * pRadius;
+			QueryBox(pCenter - extent, pCenter + extent, [&](const Entity pEntity, const Vector3& pPosition)
+			{
+				if ((pPosition - pCenter).LenghtSquared() <= radiusSquared)
+					pFunc(pEntity, pPosition);
+			});
+		}
+
+		/**
+		 * \brief Fills pResult with the pCount entities closest to pPoint, nearest first.
+		 * Cells are visited in growing shells around pPoint, stopping once no unvisited cell can hold a closer entity.
+		 */
+		void QueryNearest(const Vector3& pPoint, uint32_t pCount, std::vector<Entity>& pResult) const;
+
+		/**
+		 * \brief Finds the first entity hit by a ray, entities being treated as spheres of pRadius.
+		 * \param pDirection Direction of the ray; it does not need to be normalized.
+		 * \param pRadius Radius of the entity spheres, at most the cell size.
+		 * \return True if an entity is hit within pMaxDistance; otherwise false.
+		 */
+		bool Raycast(const Vector3& pOrigin, const Vector3& pDirection, float pMaxDistance, float pRadius, RaycastHit& pHit) const;
+
+		[[nodiscard]] size_t GetSize() const { return m_Entities.Size(); }
+		[[nodiscard]] bool Contains(const Entity pEntity) const { return m_Entities.Contains(pEntity); }
+		[[nodiscard]] float GetCellSize() const { return m_CellSize; }
+
+	private:
+		struct CellCoordinates
+		{
+			int32_t X, Y, Z;
+		};
+
+		struct Entry
+		{
+			Vector3 Position;
+			Entity Owner;
+		};
+
+		// Where the entry of an entity lives, parallel to the dense array of m_Entities.
+		struct Location
+		{
+			uint64_t Cell;
+			uint32_t Index;
+		};
+
+		struct CellHash
+		{
+			size_t operator()(const uint64_t pKey) const { return static_cast<size_t>(pKey * 0x9E3779B97F4A7C15ull >> 16); }
+		};
+
+		static constexpr int32_t k_CoordinateBias = 1 << 20;
+
+		World* m_World;
+		float m_CellSize;
+		float m_InverseCellSize;
+		std::unordered_map<uint64_t, std::vector<Entry>, CellHash> m_Cells;
+		SparseSet m_Entities;
+		std::vector<Location> m_Locations;
+		CellCoordinates m_MinCell{};
+		CellCoordinates m_MaxCell{};
+		ObserverId m_Observers[3]{};
+
+		[[nodiscard]] CellCoordinates GetCellCoordinates(const Vector3& pPosition) const
+		{
+			const auto toCell = [this](const float pValue)
+			{
+				const float cell = std::floor(pValue * m_InverseCellSize);
+				return static_cast<int32_t>(std::fmax(std::fmin(cell, k_CoordinateBias - 1.f), 1.f - k_CoordinateBias));
+			};
+			return {toCell(pPosition.x), toCell(pPosition.y), toCell(pPosition.z)};
+		}
+
+		static uint64_t GetCellKey(const CellCoordinates& pCell)
+		{
+			return static_cast<uint64_t>(pCell.X + k_CoordinateBias) << 42 | static_cast<uint64_t>(pCell.Y + k_CoordinateBias) << 21 |
+				static_cast<uint64_t>(pCell.Z + k_CoordinateBias);
+		}
+
+		[[nodiscard]] const std::vector<Entry>* FindCell(const CellCoordinates& pCell) const
+		{
+			const auto cell = m_Cells.find(GetCellKey(pCell));
+			return cell != m_Cells.end() ? &cell->second : nullptr;
+		}
+
+		void Insert(Entity pEntity, const Vector3& pPosition);
+		void Erase(Entity pEntity);
+		void Move(Entity pEntity, const Vector3& pPosition);
+		void AddToCell(uint64_t pCell, const CellCoordinates& pCoordinates, Entity pEntity, const Vector3& pPosition, Location& pLocation);
+		void RemoveFromCell(const Location& pLocation);
+	};
+}
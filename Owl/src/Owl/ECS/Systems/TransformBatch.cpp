@@ -0,0 +1,130 @@
+﻿#include "opch.h"
+#include "TransformBatch.h"
+
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "TransformBatchKernel.h"
+
+namespace Owl::Ecs
+{
+	namespace
+	{
+		static_assert(sizeof(TransformComponent) == TransformBatchKernel::k_TransformFloats * sizeof(float));
+		static_assert(sizeof(Matrix4) == TransformBatchKernel::k_MatrixFloats * sizeof(float));
+
+		struct Sse2
+		{
+			using Float = __m128;
+			using Int = __m128i;
+			static constexpr size_t Width = 4;
+
+			static Float Set(const float pValue) { return _mm_set1_ps(pValue); }
+			static Float Mul(const Float pA, const Float pB) { return _mm_mul_ps(pA, pB); }
+			static Float MulAdd(const Float pA, const Float pB, const Float pC) { return _mm_add_ps(_mm_mul_ps(pA, pB), pC); }
+			static Float And(const Float pA, const Float pB) { return _mm_and_ps(pA, pB); }
+			static Float Xor(const Float pA, const Float pB) { return _mm_xor_ps(pA, pB); }
+			static Float Select(const Float pMask, const Float pA, const Float pB) { return _mm_or_ps(_mm_and_ps(pMask, pA), _mm_andnot_ps(pMask, pB)); }
+			static Int RoundToInt(const Float pValue) { return _mm_cvtps_epi32(pValue); }
+			static Float ToFloat(const Int pValue) { return _mm_cvtepi32_ps(pValue); }
+			static Int AddInt(const Int pValue, const int pAmount) { return _mm_add_epi32(pValue, _mm_set1_epi32(pAmount)); }
+
+			static Float BitMask(const Int pValue, const int pBit)
+			{
+				const Int bit = _mm_set1_epi32(pBit);
+				return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(pValue, bit), bit));
+			}
+
+			static Float Gather(const float* pFirst)
+			{
+				constexpr size_t stride = TransformBatchKernel::k_TransformFloats;
+				return _mm_setr_ps(pFirst[0], pFirst[stride], pFirst[2 * stride], pFirst[3 * stride]);
+			}
+
+			static void StoreMatrices(const Float (&pMatrix)[TransformBatchKernel::k_MatrixFloats], float* pMatrices)
+			{
+				for (size_t row = 0; row < 4; ++row)
+				{
+					Float a = pMatrix[row * 4], b = pMatrix[row * 4 + 1], c = pMatrix[row * 4 + 2], d = pMatrix[row * 4 + 3];
+					_MM_TRANSPOSE4_PS(a, b, c, d);
+					_mm_storeu_ps(pMatrices + row * 4, a);
+					_mm_storeu_ps(pMatrices + 16 + row * 4, b);
+					_mm_storeu_ps(pMatrices + 32 + row * 4, c);
+					_mm_storeu_ps(pMatrices + 48 + row * 4, d);
+				}
+			}
+		};
+
+		bool IsAvx2Supported()
+		{
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+				return false;
+
+			__cpuid(info, 1);
+			const bool hasFma = info[2] & (1 << 12);
+			const bool hasOsXSave = info[2] & (1 << 27);
+			if (!hasFma || !hasOsXSave || (_xgetbv(0) & 0x6) != 0x6)
+				return false;
+
+			__cpuidex(info, 7, 0);
+			return info[1] & (1 << 5);
+#else
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+		}
+	}
+
+	void TransformBatch::ComputeLocalMatrices(const std::span<const TransformComponent> pTransforms, const std::span<Matrix4> pMatrices)
+	{
+		static const InstructionSet instructionSet = GetSupportedInstructionSet();
+		ComputeLocalMatrices(pTransforms, pMatrices, instructionSet);
+	}
+
+	void TransformBatch::ComputeLocalMatrices(const std::span<const TransformComponent> pTransforms, const std::span<Matrix4> pMatrices,
+	                                          const InstructionSet pInstructionSet)
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(pMatrices.size() >= pTransforms.size(), "Not enough room for the matrices.")
+		OWL_CORE_ASSERT(pInstructionSet <= GetSupportedInstructionSet(), "Instruction set not supported by this CPU.")
+
+		const float* transforms = reinterpret_cast<const float*>(pTransforms.data());
+		float* matrices = reinterpret_cast<float*>(pMatrices.data());
+
+		switch (pInstructionSet)
+		{
+		case InstructionSet::Scalar:
+			for (size_t i = 0; i < pTransforms.size(); ++i)
+				pMatrices[i] = pTransforms[i].GetLocalMatrix();
+			break;
+		case InstructionSet::Sse2:
+			TransformBatchKernel::ComputeLocalMatrices<Sse2>(transforms, matrices, pTransforms.size());
+			break;
+		case InstructionSet::Avx2:
+			TransformBatchKernel::ComputeLocalMatricesAvx2(transforms, matrices, pTransforms.size());
+			break;
+		}
+	}
+
+	TransformBatch::InstructionSet TransformBatch::GetSupportedInstructionSet()
+	{
+		// SSE2 is part of x86-64, so only AVX2 needs checking.
+		static const InstructionSet instructionSet = IsAvx2Supported() ? InstructionSet::Avx2 : InstructionSet::Sse2;
+		return instructionSet;
+	}
+
+	const char* TransformBatch::GetName(const InstructionSet pInstructionSet)
+	{
+		switch (pInstructionSet)
+		{
+		case InstructionSet::Scalar: return "Scalar";
+		case InstructionSet::Sse2: return "SSE2";
+		case InstructionSet::Avx2: return "AVX2";
+		}
+		return "Unknown";
+	}
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+#include <cstdint>
+#include <span>
+
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Computes TransformComponent::GetLocalMatrix for many transforms at once with SSE2 or AVX2,
+	 * whichever is the widest the CPU supports. TransformComponent::GetLocalMatrix stays the reference.
+	 */
+	class TransformBatch
+	{
+	public:
+		enum class InstructionSet : uint8_t
+		{
+			Scalar,
+			Sse2,
+			Avx2
+		};
+
+		/**
+		 * \brief Writes the local matrix of each transform to the matching element of pMatrices.
+		 * The vector paths use polynomial sine/cosine, within a few ULP of the reference for angles of a few turns.
+		 */
+		static void ComputeLocalMatrices(std::span<const TransformComponent> pTransforms, std::span<Matrix4> pMatrices);
+
+		/**
+		 * \brief Same as above, forcing an instruction set the CPU supports.
+		 */
+		static void ComputeLocalMatrices(std::span<const TransformComponent> pTransforms, std::span<Matrix4> pMatrices,
+		                                 InstructionSet pInstructionSet);
+
+		[[nodiscard]] static InstructionSet GetSupportedInstructionSet();
+		[[nodiscard]] static const char* GetName(InstructionSet pInstructionSet);
+	};
+}
@@ -0,0 +1,74 @@
+﻿#include <immintrin.h>
+
+#include "TransformBatchKernel.h"
+
+// Built with AVX2 code generation (see premake5.lua): keep this file to intrinsics and raw pointers, since any
+// inline function shared with other translation units could be kept in its AVX2 form by the linker.
+namespace Owl::Ecs::TransformBatchKernel
+{
+	namespace
+	{
+		struct Avx2
+		{
+			using Float = __m256;
+			using Int = __m256i;
+			static constexpr size_t Width = 8;
+
+			static Float Set(const float pValue) { return _mm256_set1_ps(pValue); }
+			static Float Mul(const Float pA, const Float pB) { return _mm256_mul_ps(pA, pB); }
+			static Float MulAdd(const Float pA, const Float pB, const Float pC) { return _mm256_fmadd_ps(pA, pB, pC); }
+			static Float And(const Float pA, const Float pB) { return _mm256_and_ps(pA, pB); }
+			static Float Xor(const Float pA, const Float pB) { return _mm256_xor_ps(pA, pB); }
+			static Float Select(const Float pMask, const Float pA, const Float pB) { return _mm256_blendv_ps(pB, pA, pMask); }
+			static Int RoundToInt(const Float pValue) { return _mm256_cvtps_epi32(pValue); }
+			static Float ToFloat(const Int pValue) { return _mm256_cvtepi32_ps(pValue); }
+			static Int AddInt(const Int pValue, const int pAmount) { return _mm256_add_epi32(pValue, _mm256_set1_epi32(pAmount)); }
+
+			static Float BitMask(const Int pValue, const int pBit)
+			{
+				const Int bit = _mm256_set1_epi32(pBit);
+				return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(pValue, bit), bit));
+			}
+
+			static Float Gather(const float* pFirst)
+			{
+				constexpr size_t stride = k_TransformFloats;
+				return _mm256_setr_ps(pFirst[0], pFirst[stride], pFirst[2 * stride], pFirst[3 * stride],
+				                      pFirst[4 * stride], pFirst[5 * stride], pFirst[6 * stride], pFirst[7 * stride]);
+			}
+
+			static void StoreMatrices(const Float (&pMatrix)[k_MatrixFloats], float* pMatrices)
+			{
+				// Transposing within 128 bit lanes leaves rows[row][i] holding that row of matrix i in its low half and of
+				// matrix i + 4 in its high half; pairs of rows are then recombined into full 256 bit stores.
+				Float rows[4][4];
+				for (size_t row = 0; row < 4; ++row)
+				{
+					const Float ab0 = _mm256_unpacklo_ps(pMatrix[row * 4], pMatrix[row * 4 + 1]);
+					const Float ab1 = _mm256_unpackhi_ps(pMatrix[row * 4], pMatrix[row * 4 + 1]);
+					const Float cd0 = _mm256_unpacklo_ps(pMatrix[row * 4 + 2], pMatrix[row * 4 + 3]);
+					const Float cd1 = _mm256_unpackhi_ps(pMatrix[row * 4 + 2], pMatrix[row * 4 + 3]);
+					rows[row][0] = _mm256_shuffle_ps(ab0, cd0, 0x44);
+					rows[row][1] = _mm256_shuffle_ps(ab0, cd0, 0xEE);
+					rows[row][2] = _mm256_shuffle_ps(ab1, cd1, 0x44);
+					rows[row][3] = _mm256_shuffle_ps(ab1, cd1, 0xEE);
+				}
+
+				for (size_t i = 0; i < 4; ++i)
+				{
+					float* low = pMatrices + i * k_MatrixFloats;
+					float* high = pMatrices + (i + 4) * k_MatrixFloats;
+					_mm256_storeu_ps(low, _mm256_permute2f128_ps(rows[0][i], rows[1][i], 0x20));
+					_mm256_storeu_ps(low + 8, _mm256_permute2f128_ps(rows[2][i], rows[3][i], 0x20));
+					_mm256_storeu_ps(high, _mm256_permute2f128_ps(rows[0][i], rows[1][i], 0x31));
+					_mm256_storeu_ps(high + 8, _mm256_permute2f128_ps(rows[2][i], rows[3][i], 0x31));
+				}
+			}
+		};
+	}
+
+	void ComputeLocalMatricesAvx2(const float* pTransforms, float* pMatrices, const size_t pCount)
+	{
+		ComputeLocalMatrices<Avx2>(pTransforms, pMatrices, pCount);
+	}
+}
@@ -0,0 +1,109 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstring>
+
+/**
+ * \brief Vector code shared by the SSE2 and AVX2 translation units of TransformBatch.
+ * Everything here is templated on the per instruction set wrapper, which each translation unit defines in an
+ * anonymous namespace, so no instantiation compiled for AVX2 can be merged into the SSE2 or scalar paths.
+ * Transforms are read as 9 packed floats (Position, Scale, Rotation) and matrices written as 16 floats.
+ */
+namespace Owl::Ecs::TransformBatchKernel
+{
+	constexpr size_t k_TransformFloats = 9;
+	constexpr size_t k_MatrixFloats = 16;
+
+	/**
+	 * \brief Defined in TransformBatchAvx2.cpp, the only file built with AVX2 code generation.
+	 */
+	void ComputeLocalMatricesAvx2(const float* pTransforms, float* pMatrices, size_t pCount);
+
+	template <typename Simd>
+	void SinCos(const typename Simd::Float pRadians, typename Simd::Float& pSin, typename Simd::Float& pCos)
+	{
+		using Float = typename Simd::Float;
+
+		// Reduce to [-pi/4, pi/4] around the nearest multiple of pi/2, with pi/2 split in three for precision.
+		const auto quadrant = Simd::RoundToInt(Simd::Mul(pRadians, Simd::Set(0.636619772f)));
+		const Float q = Simd::ToFloat(quadrant);
+		Float r = Simd::MulAdd(q, Simd::Set(-1.5703125f), pRadians);
+		r = Simd::MulAdd(q, Simd::Set(-4.837512969970703125e-4f), r);
+		r = Simd::MulAdd(q, Simd::Set(-7.549789954891882e-8f), r);
+		const Float r2 = Simd::Mul(r, r);
+
+		Float sin = Simd::MulAdd(r2, Simd::Set(-1.9515295891e-4f), Simd::Set(8.3321608736e-3f));
+		sin = Simd::MulAdd(r2, sin, Simd::Set(-1.6666654611e-1f));
+		sin = Simd::MulAdd(Simd::Mul(r2, r), sin, r);
+
+		Float cos = Simd::MulAdd(r2, Simd::Set(2.443315711809948e-5f), Simd::Set(-1.388731625493765e-3f));
+		cos = Simd::MulAdd(r2, cos, Simd::Set(4.166664568298827e-2f));
+		cos = Simd::MulAdd(Simd::Mul(r2, r2), cos, Simd::MulAdd(r2, Simd::Set(-0.5f), Simd::Set(1.f)));
+
+		// Odd quadrants swap sine and cosine; quadrants 2-3 negate the sine and 1-2 the cosine.
+		const Float swap = Simd::BitMask(quadrant, 1);
+		const Float negativeZero = Simd::Set(-0.f);
+		pSin = Simd::Xor(Simd::Select(swap, cos, sin), Simd::And(Simd::BitMask(quadrant, 2), negativeZero));
+		pCos = Simd::Xor(Simd::Select(swap, sin, cos), Simd::And(Simd::BitMask(Simd::AddInt(quadrant, 1), 2), negativeZero));
+	}
+
+	/**
+	 * \brief Scale * EulerX * EulerY * EulerZ * Translation for Simd::Width transforms, expanded by hand.
+	 */
+	template <typename Simd>
+	void ComputeBlock(const float* pTransforms, float* pMatrices)
+	{
+		using Float = typename Simd::Float;
+
+		Float sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos<Simd>(Simd::Gather(pTransforms + 6), sinX, cosX);
+		SinCos<Simd>(Simd::Gather(pTransforms + 7), sinY, cosY);
+		SinCos<Simd>(Simd::Gather(pTransforms + 8), sinZ, cosZ);
+
+		const Float scaleX = Simd::Gather(pTransforms + 3);
+		const Float scaleY = Simd::Gather(pTransforms + 4);
+		const Float scaleZ = Simd::Gather(pTransforms + 5);
+		const Float sinXSinY = Simd::Mul(sinX, sinY);
+		const Float cosXSinY = Simd::Mul(cosX, sinY);
+		const Float zero = Simd::Set(0.f);
+
+		const Float matrix[k_MatrixFloats] = {
+			Simd::Mul(scaleX, Simd::Mul(cosY, cosZ)),
+			Simd::Mul(scaleX, Simd::Mul(cosY, sinZ)),
+			Simd::Mul(scaleX, Simd::Xor(sinY, Simd::Set(-0.f))),
+			zero,
+			Simd::Mul(scaleY, Simd::MulAdd(sinXSinY, cosZ, Simd::Mul(Simd::Xor(cosX, Simd::Set(-0.f)), sinZ))),
+			Simd::Mul(scaleY, Simd::MulAdd(sinXSinY, sinZ, Simd::Mul(cosX, cosZ))),
+			Simd::Mul(scaleY, Simd::Mul(sinX, cosY)),
+			zero,
+			Simd::Mul(scaleZ, Simd::MulAdd(cosXSinY, cosZ, Simd::Mul(sinX, sinZ))),
+			Simd::Mul(scaleZ, Simd::MulAdd(cosXSinY, sinZ, Simd::Mul(Simd::Xor(sinX, Simd::Set(-0.f)), cosZ))),
+			Simd::Mul(scaleZ, Simd::Mul(cosX, cosY)),
+			zero,
+			Simd::Gather(pTransforms + 0),
+			Simd::Gather(pTransforms + 1),
+			Simd::Gather(pTransforms + 2),
+			Simd::Set(1.f)
+		};
+		Simd::StoreMatrices(matrix, pMatrices);
+	}
+
+	template <typename Simd>
+	void ComputeLocalMatrices(const float* pTransforms, float* pMatrices, const size_t pCount)
+	{
+		constexpr size_t width = Simd::Width;
+
+		size_t i = 0;
+		for (; i + width <= pCount; i += width)
+			ComputeBlock<Simd>(pTransforms + i * k_TransformFloats, pMatrices + i * k_MatrixFloats);
+
+		// The tail goes through the same code, padded, so every transform gets bit identical results.
+		if (const size_t rest = pCount - i)
+		{
+			float transforms[width * k_TransformFloats] = {};
+			float matrices[width * k_MatrixFloats];
+			std::memcpy(transforms, pTransforms + i * k_TransformFloats, rest * k_TransformFloats * sizeof(float));
+			ComputeBlock<Simd>(transforms, matrices);
+			std::memcpy(pMatrices + i * k_MatrixFloats, matrices, rest * k_MatrixFloats * sizeof(float));
+		}
+	}
+}
@@ -0,0 +1,251 @@
+﻿#include "opch.h"
+#include "TransformSystem.h"
+
+#include "Owl/ECS/World.h"
+#include "Owl/ECS/Components/ChildrenComponent.h"
+#include "Owl/ECS/Components/ParentComponent.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+#include "Owl/ECS/Components/WorldTransformComponent.h"
+#include "Owl/ECS/Systems/TransformBatch.h"
+
+namespace Owl::Ecs
+{
+	TransformSystem::TransformSystem(World* pWorld)
+		: System(pWorld)
+	{
+		Reads<TransformComponent, ParentComponent>();
+		// Children lists are written too: updates drop the handles of destroyed children from them.
+		Writes<WorldTransformComponent, ChildrenComponent>();
+
+		m_World->Observe<ChildrenComponent>(ComponentEvent::Removed, [this](const std::span<const Entity> pParents)
+		{
+			OrphanChildren(pParents);
+		});
+	}
+
+	void TransformSystem::SetParent(const Entity pChild, const Entity pParent)
+	{
+		OWL_CORE_ASSERT(!IsAncestor(pChild, pParent), "Parenting would create a cycle in the hierarchy.")
+
+		if (const ParentComponent* current = m_World->TryGetComponent<ParentComponent>(pChild))
+		{
+			if (current->Parent == pParent)
+				return;
+
+			DetachFromParent(pChild, current->Parent);
+			m_World->GetComponent<ParentComponent>(pChild).Parent = pParent;
+		}
+		else
+		{
+			m_World->AddComponent(pChild, ParentComponent{pParent});
+		}
+
+		if (ChildrenComponent* children = m_World->TryGetComponent<ChildrenComponent>(pParent))
+			children->Children.push_back(pChild);
+		else
+			m_World->AddComponent(pParent, ChildrenComponent{{pChild}});
+
+		const ParentComponent* grandParent = m_World->TryGetComponent<ParentComponent>(pParent);
+		SetDepth(pChild, grandParent ? grandParent->Depth + 1 : 1);
+	}
+
+	void TransformSystem::RemoveParent(const Entity pChild)
+	{
+		const ParentComponent* current = m_World->TryGetComponent<ParentComponent>(pChild);
+		if (!current)
+			return;
+
+		DetachFromParent(pChild, current->Parent);
+		m_World->RemoveComponent<ParentComponent>(pChild);
+
+		// The child no longer carries a changed ParentComponent, so flag its transform to get it recomputed.
+		(void)m_World->GetComponent<TransformComponent>(pChild);
+		SetDepth(pChild, 0);
+	}
+
+	void TransformSystem::OnUpdate(Timestep)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		const uint32_t since = GetLastUpdateTick();
+		const auto collect = [this](const Entity pEntity, const WorldTransformComponent&)
+		{
+			const ParentComponent* parent = std::as_const(*m_World).TryGetComponent<ParentComponent>(pEntity);
+			m_Dirty.emplace_back(parent ? parent->Depth : 0, pEntity);
+		};
+
+		m_Dirty.clear();
+		m_World->View<const WorldTransformComponent, Changed<TransformComponent>>(since).Each(collect);
+		m_World->View<const WorldTransformComponent, Changed<ParentComponent>>(since).Each(collect);
+		if (m_Dirty.empty())
+			return;
+
+		// Parents come first, so a subtree update always starts from an up to date parent matrix.
+		std::sort(m_Dirty.begin(), m_Dirty.end());
+
+		for (const auto& [depth, entity] : m_Dirty)
+			CollectSubtree(entity);
+		UpdateCollected();
+	}
+
+	bool TransformSystem::IsAncestor(const Entity pAncestor, Entity pEntity) const
+	{
+		const World& world = *m_World;
+		while (pEntity != pAncestor)
+		{
+			const ParentComponent* parent = world.TryGetComponent<ParentComponent>(pEntity);
+			if (!parent)
+				return false;
+			pEntity = parent->Parent;
+		}
+		return true;
+	}
+
+	void TransformSystem::DetachFromParent(const Entity pChild, const Entity pParent) const
+	{
+		if (!m_World->IsAlive(pParent))
+			return;
+
+		if (ChildrenComponent* children = m_World->TryGetComponent<ChildrenComponent>(pParent))
+			std::erase(children->Children, pChild);
+	}
+
+	void TransformSystem::EraseDestroyedChildren(const Entity pParent) const
+	{
+		const World& world = *m_World;
+		std::erase_if(m_World->GetComponent<ChildrenComponent>(pParent).Children, [&world](const Entity pChild)
+		{
+			return !world.IsAlive(pChild);
+		});
+	}
+
+	void TransformSystem::OrphanChildren(const std::span<const Entity> pParents)
+	{
+		SparseSet destroyed;
+		for (const Entity parent : pParents)
+		{
+			if (!m_World->IsAlive(parent))
+				destroyed.Insert(parent);
+		}
+		if (destroyed.Empty())
+			return;
+
+		// The children list died with the parent, so its children are found through their ParentComponent.
+		std::vector<Entity> orphans;
+		m_World->View<const ParentComponent>().Each([&destroyed, &orphans](const Entity pEntity, const ParentComponent& pParent)
+		{
+			if (destroyed.Contains(pParent.Parent))
+				orphans.push_back(pEntity);
+		});
+
+		for (const Entity orphan : orphans)
+		{
+			m_World->RemoveComponent<ParentComponent>(orphan);
+			SetDepth(orphan, 0);
+			if (m_World->HasComponent<WorldTransformComponent>(orphan))
+				CollectSubtree(orphan);
+		}
+		UpdateCollected();
+	}
+
+	void TransformSystem::SetDepth(const Entity pRoot, const uint32_t pDepth)
+	{
+		const World& world = *m_World;
+
+		if (pDepth > 0)
+			m_World->GetComponent<ParentComponent>(pRoot).Depth = pDepth;
+
+		// Writing each descendant's ParentComponent also flags it for the next update.
+		m_Pending.clear();
+		m_Pending.push_back(pRoot);
+		while (!m_Pending.empty())
+		{
+			const Entity entity = m_Pending.back();
+			m_Pending.pop_back();
+
+			const ChildrenComponent* children = world.TryGetComponent<ChildrenComponent>(entity);
+			if (!children)
+				continue;
+
+			const uint32_t depth = entity == pRoot ? pDepth : world.GetComponent<ParentComponent>(entity).Depth;
+			bool hasDestroyedChild = false;
+			for (const Entity child : children->Children)
+			{
+				if (!world.IsAlive(child))
+				{
+					hasDestroyedChild = true;
+					continue;
+				}
+
+				m_World->GetComponent<ParentComponent>(child).Depth = depth + 1;
+				m_Pending.push_back(child);
+			}
+
+			if (hasDestroyedChild)
+				EraseDestroyedChildren(entity);
+		}
+	}
+
+	void TransformSystem::CollectSubtree(const Entity pRoot)
+	{
+		const World& world = *m_World;
+
+		m_Pending.clear();
+		m_Pending.push_back(pRoot);
+
+		// A child is only pushed once its parent is collected, so parents always come first.
+		while (!m_Pending.empty())
+		{
+			const Entity entity = m_Pending.back();
+			m_Pending.pop_back();
+
+			if (m_Updated.Contains(entity))
+				continue;
+			m_Updated.Insert(entity);
+			m_Collected.push_back(entity);
+
+			if (const ChildrenComponent* children = world.TryGetComponent<ChildrenComponent>(entity))
+			{
+				// Destroyed children leave their handle behind; they are dropped the first time they are met.
+				bool hasDestroyedChild = false;
+				for (const Entity child : children->Children)
+				{
+					if (!world.IsAlive(child))
+						hasDestroyedChild = true;
+					else if (world.HasComponent<WorldTransformComponent>(child))
+						m_Pending.push_back(child);
+				}
+
+				if (hasDestroyedChild)
+					EraseDestroyedChildren(entity);
+			}
+		}
+	}
+
+	void TransformSystem::UpdateCollected()
+	{
+		const World& world = *m_World;
+		const size_t count = m_Collected.size();
+
+		m_Locals.resize(count);
+		m_Matrices.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			m_Locals[i] = world.GetComponent<TransformComponent>(m_Collected[i]);
+		TransformBatch::ComputeLocalMatrices(m_Locals, m_Matrices);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Entity entity = m_Collected[i];
+			Matrix4 matrix = m_Matrices[i];
+			if (const ParentComponent* parent = world.TryGetComponent<ParentComponent>(entity); parent && world.IsAlive(parent->Parent))
+			{
+				if (const WorldTransformComponent* parentWorld = world.TryGetComponent<WorldTransformComponent>(parent->Parent))
+					matrix *= parentWorld->Matrix;
+			}
+			m_World->GetComponent<WorldTransformComponent>(entity).Matrix = matrix;
+		}
+
+		m_Collected.clear();
+		m_Updated.Clear();
+	}
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Owl/ECS/SparseSet.h"
+#include "Owl/ECS/System.h"
+#include "Owl/ECS/Components/TransformComponent.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief Keeps WorldTransformComponent up to date for every entity with a TransformComponent and a
+	 * WorldTransformComponent, following ParentComponent/ChildrenComponent links.
+	 * Only entities whose transform or parent changed since the last update are recomputed, together with
+	 * their subtrees, in depth order. A frame where neither pool changed returns without visiting any entity.
+	 * The local matrices of everything recomputed in a frame are built in one TransformBatch call.
+	 * Destroying a parent turns its children into roots when observers are next flushed.
+	 * Requires StorageMode::ComponentPools and the four components to be registered before the system.
+	 */
+	class TransformSystem final : public System
+	{
+	public:
+		explicit TransformSystem(World* pWorld);
+
+		/**
+		 * \brief Attaches pChild below pParent, detaching it from its previous parent first.
+		 */
+		void SetParent(Entity pChild, Entity pParent);
+
+		/**
+		 * \brief Turns pChild back into a root. Its descendants stay attached to it.
+		 */
+		void RemoveParent(Entity pChild);
+
+		void OnUpdate(Timestep pTimestep) override;
+
+	private:
+		std::vector<std::pair<uint32_t, Entity>> m_Dirty;
+		std::vector<Entity> m_Pending;
+		SparseSet m_Updated;
+		// The entities to recompute, parents before children, with their transforms and local matrices.
+		std::vector<Entity> m_Collected;
+		std::vector<TransformComponent> m_Locals;
+		std::vector<Matrix4> m_Matrices;
+
+		[[nodiscard]] bool IsAncestor(Entity pAncestor, Entity pEntity) const;
+		void DetachFromParent(Entity pChild, Entity pParent) const;
+		void EraseDestroyedChildren(Entity pParent) const;
+		void OrphanChildren(std::span<const Entity> pParents);
+		void SetDepth(Entity pRoot, uint32_t pDepth);
+		void CollectSubtree(Entity pRoot);
+		void UpdateCollected();
+	};
+}
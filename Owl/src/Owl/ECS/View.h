@@ -0,0 +1,293 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentArray.h"
+#include "Ecs.h"
+#include "EntityManager.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief View filter: only entities whose T was added after the view's since tick.
+	 */
+	template <typename T>
+	struct Added
+	{
+	};
+
+	/**
+	 * \brief View filter: only entities whose T was added or obtained mutably after the view's since tick.
+	 */
+	template <typename T>
+	struct Changed
+	{
+	};
+
+	/**
+	 * \brief View item: reads T from the published buffer of its double-buffered pool, as of the last
+	 * World::PublishFrame. Systems may read it while others write T, but not while T is added or removed; see
+	 * System::ReadsPublished.
+	 */
+	template <typename T>
+	struct Previous
+	{
+	};
+
+	/**
+	 * \brief How a View treats one of its type arguments. Plain types are fetched mutably and stamped as changed,
+	 * const types are fetched read only, and filters restrict the visited entities without being fetched.
+	 */
+	template <typename T>
+	struct ViewItem
+	{
+		using Component = std::remove_const_t<T>;
+		static constexpr bool IsFetched = true;
+		static constexpr bool IsMutable = !std::is_const_v<T>;
+		static constexpr bool IsPublished = false;
+
+		static bool Accepts(const ComponentTicks&, uint32_t) { return true; }
+	};
+
+	template <typename T>
+	struct ViewItem<Added<T>>
+	{
+		using Component = T;
+		static constexpr bool IsFetched = false;
+		static constexpr bool IsMutable = false;
+		static constexpr bool IsPublished = false;
+
+		static bool Accepts(const ComponentTicks& pTicks, const uint32_t pSinceTick) { return IsNewerTick(pTicks.Added, pSinceTick); }
+	};
+
+	template <typename T>
+	struct ViewItem<Changed<T>>
+	{
+		using Component = T;
+		static constexpr bool IsFetched = false;
+		static constexpr bool IsMutable = false;
+		static constexpr bool IsPublished = false;
+
+		static bool Accepts(const ComponentTicks& pTicks, const uint32_t pSinceTick) { return IsNewerTick(pTicks.Changed, pSinceTick); }
+	};
+
+	template <typename T>
+	struct ViewItem<Previous<T>>
+	{
+		using Component = T;
+		static constexpr bool IsFetched = true;
+		static constexpr bool IsMutable = false;
+		static constexpr bool IsPublished = true;
+
+		static bool Accepts(const ComponentTicks&, uint32_t) { return true; }
+	};
+
+	template <typename T>
+	using ViewComponent = typename ViewItem<T>::Component;
+
+	/**
+	 * \brief Stands in for the pool of a tag in a View: tags have no storage and are matched on the entity signature.
+	 */
+	struct TagPool
+	{
+	};
+
+	template <typename T>
+	constexpr bool IsViewTag = IsTagComponent<ViewComponent<T>>;
+
+	template <typename T>
+	using ViewPool = std::conditional_t<IsViewTag<T>, TagPool, ComponentArray<ViewComponent<T>>>;
+
+	/**
+	 * \brief Iterates every entity owning all of Ts, driven by the smallest of the involved pools.
+	 * The driving pool is walked by dense index; the others are probed through their sparse arrays.
+	 * Iteration runs back to front, so the callback may remove components from the current entity.
+	 * Ts may be const qualified to read without stamping, Previous<T> to read the published buffer of a double-buffered
+	 * pool, or Added<T>/Changed<T> to filter on change ticks. Tags filter on the entity signature and are not passed
+	 * to the callback; they need at least one stored component to drive the view, so iterate a tag alone through a
+	 * system whose signature holds it.
+	 */
+	template <typename... Ts>
+	class View
+	{
+	public:
+		static_assert(((!IsViewTag<Ts> || (ViewItem<Ts>::IsFetched && !ViewItem<Ts>::IsPublished)) && ...),
+		              "Tags have no ticks nor published buffer; use them as plain View items.");
+		static_assert((!IsViewTag<Ts> || ...), "A View needs at least one stored component to drive it.");
+
+		/**
+		 * \param pSinceTick Added/Changed filters accept components stamped after this tick.
+		 * \param pTags The types of the tags among Ts, tested against the signatures of pEntityManager.
+		 */
+		explicit View(const uint32_t pSinceTick, const EntityManager& pEntityManager, const Signature pTags, ViewPool<Ts>&... pArrays)
+			: m_Arrays{&pArrays...}, m_EntityManager(&pEntityManager), m_Tags(pTags), m_SinceTick(pSinceTick)
+		{
+			OWL_CORE_ASSERT(((!ViewItem<Ts>::IsPublished || IsDoubleBuffered(pArrays)) && ...),
+			                "Previous<T> requires the pool of T to be double-buffered.")
+		}
+
+		template <typename Func>
+		void Each(Func&& pFunc) const
+		{
+			// A filter on a pool that has not changed since the tick rejects everything, without walking it.
+			if (!CanPass(std::index_sequence_for<Ts...>{}))
+				return;
+
+			EachDriven(GetSmallestPool(), pFunc, std::index_sequence_for<Ts...>{});
+		}
+
+		/**
+		 * \brief Upper bound of the number of entities the view visits.
+		 */
+		[[nodiscard]] size_t SizeHint() const
+		{
+			return std::apply([](auto*... pArrays) { return std::min({GetSize(pArrays)...}); }, m_Arrays);
+		}
+
+	private:
+		std::tuple<ViewPool<Ts>*...> m_Arrays;
+		const EntityManager* m_EntityManager;
+		Signature m_Tags;
+		uint32_t m_SinceTick;
+
+		// Tags never drive the view, so they report no size bound.
+		static size_t GetSize(const TagPool*) { return SIZE_MAX; }
+
+		template <typename T>
+		static size_t GetSize(const ComponentArray<T>* pArray) { return pArray->GetSize(); }
+
+		static bool IsDoubleBuffered(const TagPool&) { return false; }
+
+		template <typename T>
+		static bool IsDoubleBuffered(const ComponentArray<T>& pArray) { return pArray.IsDoubleBuffered(); }
+
+		[[nodiscard]] size_t GetSmallestPool() const
+		{
+			size_t sizes[sizeof...(Ts)];
+			std::apply([&sizes](auto*... pArrays)
+			{
+				size_t i = 0;
+				((sizes[i++] = GetSize(pArrays)), ...);
+			}, m_Arrays);
+
+			size_t smallest = 0;
+			for (size_t i = 1; i < sizeof...(Ts); ++i)
+			{
+				if (sizes[i] < sizes[smallest])
+					smallest = i;
+			}
+			return smallest;
+		}
+
+		template <size_t... Is>
+		[[nodiscard]] bool CanPass(std::index_sequence<Is...>) const
+		{
+			return (CanPass<Is>() && ...);
+		}
+
+		template <size_t I>
+		[[nodiscard]] bool CanPass() const
+		{
+			using Item = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			if constexpr (ViewItem<Item>::IsFetched)
+				return true;
+			else
+				return IsNewerTick(std::get<I>(m_Arrays)->GetLastChangeTick(), m_SinceTick);
+		}
+
+		template <typename Func, size_t... Is>
+		void EachDriven(const size_t pDriver, Func& pFunc, std::index_sequence<Is...>) const
+		{
+			(EachDrivenBy<Is>(pDriver, pFunc) || ...);
+		}
+
+		template <size_t I, typename Func>
+		bool EachDrivenBy(const size_t pDriver, Func& pFunc) const
+		{
+			if constexpr (IsViewTag<std::tuple_element_t<I, std::tuple<Ts...>>>)
+				return false;
+			else
+			{
+				if (pDriver != I)
+					return false;
+
+				EachFrom<I>(pFunc, std::index_sequence_for<Ts...>{});
+				return true;
+			}
+		}
+
+		template <size_t Driver, typename Func, size_t... Is>
+		void EachFrom(Func& pFunc, std::index_sequence<Is...>) const
+		{
+			auto* driver = std::get<Driver>(m_Arrays);
+			const Entity* entities = driver->GetEntities().Data();
+
+			for (size_t i = driver->GetSize(); i-- > 0;)
+			{
+				const Entity entity = entities[i];
+				const std::array<uint32_t, sizeof...(Ts)> indices{Find<Is, Driver>(entity, i)...};
+
+				if (((indices[Is] == SparseSet::k_Invalid) || ...))
+					continue;
+				if (!(Accepts<Is>(indices[Is]) && ...))
+					continue;
+				if (m_Tags.any() && (m_EntityManager->GetSignature(entity) & m_Tags) != m_Tags)
+					continue;
+
+				(Stamp<Is>(indices[Is]), ...);
+				std::apply([&pFunc, entity](auto&... pComponents) { InvokeQuery(pFunc, entity, pComponents...); },
+				           std::tuple_cat(Fetch<Is>(indices[Is])...));
+			}
+		}
+
+		template <size_t I, size_t Driver>
+		uint32_t Find(const Entity pEntity, const size_t pIndex) const
+		{
+			if constexpr (I == Driver)
+				return static_cast<uint32_t>(pIndex);
+			else if constexpr (IsViewTag<std::tuple_element_t<I, std::tuple<Ts...>>>)
+				return 0;
+			else
+				return std::get<I>(m_Arrays)->GetEntities().Find(pEntity);
+		}
+
+		template <size_t I>
+		[[nodiscard]] bool Accepts(const uint32_t pIndex) const
+		{
+			using Item = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			if constexpr (IsViewTag<Item>)
+				return true;
+			else
+				return ViewItem<Item>::Accepts(std::get<I>(m_Arrays)->GetTicks(pIndex), m_SinceTick);
+		}
+
+		template <size_t I>
+		void Stamp(const size_t pIndex) const
+		{
+			using Item = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			if constexpr (ViewItem<Item>::IsMutable && !IsViewTag<Item>)
+				std::get<I>(m_Arrays)->MarkChanged(pIndex);
+		}
+
+		template <size_t I>
+		auto Fetch(const size_t pIndex) const
+		{
+			using Item = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+			if constexpr (!ViewItem<Item>::IsFetched || IsViewTag<Item>)
+				return std::tuple<>{};
+			else if constexpr (ViewItem<Item>::IsPublished)
+				return std::tuple<const ViewComponent<Item>&>{std::get<I>(m_Arrays)->PublishedData()[pIndex]};
+			else if constexpr (ViewItem<Item>::IsMutable)
+				return std::tuple<ViewComponent<Item>&>{std::get<I>(m_Arrays)->Data()[pIndex]};
+			else
+				return std::tuple<const ViewComponent<Item>&>{std::get<I>(m_Arrays)->Data()[pIndex]};
+		}
+	};
+}
@@ -1,6 +1,8 @@
 ﻿#include "opch.h"
 #include "World.h"
 
+#include "Prefab.h"
+
 namespace Owl::Ecs
 {
 	World::~World()
@@ -8,10 +10,19 @@ namespace Owl::Ecs
 		OWL_PROFILE_FUNCTION();
 	}
 
-	void World::Initialize()
+	void World::Initialize(const StorageMode pStorageMode, const uint32_t pReserveEntities)
 	{
+		m_StorageMode = pStorageMode;
+		if (m_StorageMode == StorageMode::Archetypes)
+		{
+			m_ArchetypeManager = std::make_unique<ArchetypeManager>();
+			m_ArchetypeManager->Reserve(pReserveEntities);
+		}
+
 		m_ComponentManager = std::make_unique<ComponentManager>();
-		m_EntityManager = std::make_unique<EntityManager>();
+		m_EntityManager = std::make_unique<EntityManager>(pReserveEntities);
+		m_ObserverManager = std::make_unique<ObserverManager>();
+		m_ResourceManager = std::make_unique<ResourceManager>();
 		m_SystemManager = std::make_unique<SystemManager>();
 	}
 
@@ -20,10 +31,77 @@ namespace Owl::Ecs
 		return m_EntityManager->CreateEntity();
 	}
 
+	void World::Instantiate(const Prefab& pPrefab, const std::span<Entity> pEntities) const
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(pPrefab.m_World == this, "Prefab built for another world.")
+
+		const Signature signature = pPrefab.GetSignature();
+		m_EntityManager->CreateEntities(pEntities, signature);
+
+		if (m_StorageMode == StorageMode::Archetypes)
+		{
+			m_ArchetypeManager->CreateEntities(pEntities, signature, [&pPrefab](const Archetype& pArchetype, const uint32_t pRow)
+			{
+				for (const Prefab::Component& component : pPrefab.m_Components)
+					component.ConstructCopy(pArchetype.GetComponent(component.Type, pRow), component.Prototype.get());
+			});
+		}
+		else
+		{
+			for (const Prefab::Component& component : pPrefab.m_Components)
+				component.InsertCopies(*m_ComponentManager->GetComponentArray(component.Type), pEntities, component.Prototype.get());
+		}
+
+		CommitCreatedEntities(pEntities, signature);
+	}
+
+	std::vector<Entity> World::Instantiate(const Prefab& pPrefab, const uint32_t pCount) const
+	{
+		std::vector<Entity> entities(pCount);
+		Instantiate(pPrefab, std::span<Entity>(entities));
+		return entities;
+	}
+
 	void World::DestroyEntity(const Entity pEntity) const
 	{
+		const Signature signature = m_EntityManager->GetSignature(pEntity);
+
 		m_EntityManager->DestroyEntity(pEntity);
-		m_ComponentManager->EntityDestroyed(pEntity);
-		m_SystemManager->EntityDestroyed(pEntity);
+		if (m_StorageMode == StorageMode::Archetypes)
+			m_ArchetypeManager->EntityDestroyed(pEntity);
+		else
+			m_ComponentManager->EntityDestroyed(pEntity);
+		m_SystemManager->EntityDestroyed(pEntity, signature);
+		m_ObserverManager->EntityDestroyed(pEntity, signature);
+	}
+
+	void World::Update(const Timestep pTimestep) const
+	{
+		m_SystemManager->Update(pTimestep, *m_ComponentManager, *m_ResourceManager);
+		PublishFrame();
+		FlushObservers();
+	}
+
+	void World::CommitCreatedEntities(const std::span<const Entity> pEntities, const Signature pSignature) const
+	{
+		m_SystemManager->EntitiesCreated(pEntities, pSignature);
+		m_ObserverManager->EntitiesCreated(pEntities, pSignature);
+	}
+
+	void World::CommitSignature(const Entity pEntity, const Signature pOldSignature, const Signature pNewSignature) const
+	{
+		m_EntityManager->SetSignature(pEntity, pNewSignature);
+		m_SystemManager->EntitySignatureChanged(pEntity, pOldSignature, pNewSignature);
+		m_ObserverManager->EntitySignatureChanged(pEntity, pOldSignature, pNewSignature);
+	}
+
+	void World::CommitAddedComponent(const std::span<const Entity> pEntities, const ComponentType pType) const
+	{
+		for (const Entity entity : pEntities)
+		{
+			const Signature oldSignature = m_EntityManager->GetSignature(entity);
+			CommitSignature(entity, oldSignature, Signature(oldSignature).set(pType));
+		}
 	}
 }
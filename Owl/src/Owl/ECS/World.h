@@ -1,64 +1,340 @@
 ﻿#pragma once
 #include <memory>
+#include <span>
+#include <vector>
 
+#include "ArchetypeManager.h"
 #include "ComponentManager.h"
 #include "EntityManager.h"
+#include "Group.h"
+#include "ObserverManager.h"
+#include "ResourceManager.h"
 #include "SystemManager.h"
+#include "View.h"
 
 namespace Owl::Ecs
 {
+	class Prefab;
+
 	class World
 	{
 	public:
 		~World();
-		void Initialize();
+		/**
+		 * \brief Creates the managers of the world.
+		 * \param pStorageMode How component data is laid out in memory.
+		 * \param pReserveEntities Optional hint of how many entities the world will hold.
+		 * Storage grows on demand either way; the hint only avoids reallocations while it does.
+		 */
+		void Initialize(StorageMode pStorageMode = StorageMode::ComponentPools, uint32_t pReserveEntities = 0);
 
 		Entity CreateEntity() const;
+
+		/**
+		 * \brief Fills pEntities with new entities that each start with a copy of pComponents.
+		 * Storage is grown once, components are written contiguously and system membership is updated once per batch.
+		 */
+		template <typename... Ts>
+		void CreateEntities(const std::span<Entity> pEntities, const Ts&... pComponents) const
+		{
+			Signature signature;
+			(signature.set(m_ComponentManager->GetComponentType<Ts>()), ...);
+
+			m_EntityManager->CreateEntities(pEntities, signature);
+			if (m_StorageMode == StorageMode::Archetypes)
+				m_ArchetypeManager->CreateEntities<Ts...>(pEntities, {m_ComponentManager->GetComponentType<Ts>()...}, pComponents...);
+			else
+				(InsertComponents<Ts>(pEntities, pComponents), ...);
+
+			CommitCreatedEntities(pEntities, signature);
+		}
+
+		template <typename... Ts>
+		std::vector<Entity> CreateEntities(const uint32_t pCount, const Ts&... pComponents) const
+		{
+			std::vector<Entity> entities(pCount);
+			CreateEntities(std::span<Entity>(entities), pComponents...);
+			return entities;
+		}
+
+		/**
+		 * \brief Fills pEntities with new entities that each start with a copy of the components of pPrefab.
+		 * Each component is copied into its storage as one block and system membership is updated once per batch.
+		 */
+		void Instantiate(const Prefab& pPrefab, std::span<Entity> pEntities) const;
+		std::vector<Entity> Instantiate(const Prefab& pPrefab, uint32_t pCount) const;
+
 		void DestroyEntity(Entity pEntity) const;
+		[[nodiscard]] bool IsAlive(const Entity pEntity) const { return m_EntityManager->IsAlive(pEntity); }
 
 
 		template <typename T>
 		void RegisterComponent() const
 		{
-			m_ComponentManager->RegisterComponent<T>();
+			if (m_StorageMode == StorageMode::Archetypes)
+				m_ArchetypeManager->RegisterComponent<T>(m_ComponentManager->RegisterComponentType<T>());
+			else
+				m_ComponentManager->RegisterComponent<T>();
+		}
+
+		template <typename T>
+		void ReserveComponents(const size_t pCount) const
+		{
+			if constexpr (!IsTagComponent<T>)
+			{
+				if (m_StorageMode == StorageMode::ComponentPools)
+					m_ComponentManager->Reserve<T>(pCount);
+			}
 		}
 
 		template <typename T>
 		void AddComponent(const Entity pEntity, T pComponent)
 		{
-			m_ComponentManager->AddComponent<T>(pEntity, pComponent);
+			const ComponentType type = m_ComponentManager->GetComponentType<T>();
+			OWL_CORE_ASSERT(!IsTagComponent<T> || !HasComponent<T>(pEntity), "Tag added to same entity more than once.")
+			StoreComponent<T>(pEntity, type, std::move(pComponent));
 
-			auto signature = m_EntityManager->GetSignature(pEntity);
-			signature.set(m_ComponentManager->GetComponentType<T>(), true);
-			m_EntityManager->SetSignature(pEntity, signature);
+			const auto oldSignature = m_EntityManager->GetSignature(pEntity);
+			auto signature = oldSignature;
+			signature.set(type, true);
+			CommitSignature(pEntity, oldSignature, signature);
+		}
+
+		/**
+		 * \brief Gives every entity of pEntities a copy of pComponent. The pool is grown once for the whole range.
+		 */
+		template <typename T>
+		void AddComponents(const std::span<const Entity> pEntities, const T& pComponent) const
+		{
+			const ComponentType type = m_ComponentManager->GetComponentType<T>();
+			if (m_StorageMode == StorageMode::Archetypes)
+			{
+				for (const Entity entity : pEntities)
+					m_ArchetypeManager->AddComponent<T>(entity, type, pComponent);
+			}
+			else
+				InsertComponents<T>(pEntities, pComponent);
 
-			m_SystemManager->EntitySignatureChanged(pEntity, signature);
+			CommitAddedComponent(pEntities, type);
 		}
 
+		/**
+		 * \brief Gives pEntities[i] the component pComponents[i]. The pool is grown once for the whole range.
+		 */
 		template <typename T>
-		void RemoveComponent(const Entity pEntity) const
+		void AddComponents(const std::span<const Entity> pEntities, const std::span<const T> pComponents) const
 		{
-			m_ComponentManager->RemoveComponent<T>(pEntity);
+			OWL_CORE_ASSERT(pEntities.size() == pComponents.size(), "Entity and component ranges differ in size.")
 
-			auto signature = m_EntityManager->GetSignature(pEntity);
-			signature.set(m_ComponentManager->GetComponentType<T>(), false);
-			m_EntityManager->SetSignature(pEntity, signature);
+			const ComponentType type = m_ComponentManager->GetComponentType<T>();
+			if (m_StorageMode == StorageMode::Archetypes)
+			{
+				for (size_t i = 0; i < pEntities.size(); ++i)
+					m_ArchetypeManager->AddComponent<T>(pEntities[i], type, pComponents[i]);
+			}
+			else if constexpr (!IsTagComponent<T>)
+				m_ComponentManager->GetComponentArray<T>().InsertData(pEntities, pComponents);
 
-			m_SystemManager->EntitySignatureChanged(pEntity, signature);
+			CommitAddedComponent(pEntities, type);
+		}
+
+		template <typename T>
+		void RemoveComponent(const Entity pEntity) const
+		{
+			const ComponentType type = m_ComponentManager->GetComponentType<T>();
+			OWL_CORE_ASSERT(!IsTagComponent<T> || HasComponent<T>(pEntity), "Removing non-existent tag.")
+			EraseComponent<T>(pEntity, type);
+
+			const auto oldSignature = m_EntityManager->GetSignature(pEntity);
+			auto signature = oldSignature;
+			signature.set(type, false);
+			CommitSignature(pEntity, oldSignature, signature);
 		}
 
 		template <typename T>
 		T& GetComponent(const Entity pEntity)
 		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				return m_ArchetypeManager->GetComponent<T>(pEntity, m_ComponentManager->GetComponentType<T>());
+
 			return m_ComponentManager->GetComponent<T>(pEntity);
 		}
 
+		template <typename T>
+		[[nodiscard]] bool HasComponent(const Entity pEntity) const
+		{
+			return m_EntityManager->GetSignature(pEntity).test(m_ComponentManager->GetComponentType<T>());
+		}
+
+		/**
+		 * \brief Like GetComponent, but returns nullptr when pEntity has no T.
+		 */
+		template <typename T>
+		T* TryGetComponent(const Entity pEntity)
+		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				return HasComponent<T>(pEntity) ? &GetComponent<T>(pEntity) : nullptr;
+
+			return m_ComponentManager->GetComponentArray<T>().TryGetData(pEntity);
+		}
+
+		template <typename T>
+		const T* TryGetComponent(const Entity pEntity) const
+		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				return HasComponent<T>(pEntity) ? &GetComponent<T>(pEntity) : nullptr;
+
+			return std::as_const(m_ComponentManager->GetComponentArray<T>()).TryGetData(pEntity);
+		}
+
+		/**
+		 * \brief Read only access; unlike the mutable overload it does not stamp the component as changed.
+		 */
+		template <typename T>
+		const T& GetComponent(const Entity pEntity) const
+		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				return m_ArchetypeManager->GetComponent<T>(pEntity, m_ComponentManager->GetComponentType<T>());
+
+			return std::as_const(m_ComponentManager->GetComponentArray<T>()).GetData(pEntity);
+		}
+
+		/**
+		 * \brief Builds a query over every entity owning all of Ts. Tags among Ts filter the entities without being
+		 * passed to the callback. Requires StorageMode::ComponentPools.
+		 * \param pSinceTick Added<T>/Changed<T> items only accept components stamped after this tick,
+		 * typically System::GetLastUpdateTick().
+		 */
+		template <typename... Ts>
+		Ecs::View<Ts...> View(const uint32_t pSinceTick = 0) const
+		{
+			OWL_CORE_ASSERT(m_StorageMode == StorageMode::ComponentPools, "Views require component pool storage.")
+
+			Signature tags;
+			(tags.set(m_ComponentManager->GetComponentType<ViewComponent<Ts>>(), IsViewTag<Ts>), ...);
+			return Ecs::View<Ts...>(pSinceTick, *m_EntityManager, tags, GetViewPool<Ts>()...);
+		}
+
+		/**
+		 * \brief Makes Ts an owned group and returns it. The entities owning all of Ts are then kept packed at the
+		 * front of each of their pools, in the same order, so the group iterates them without any lookup. Opt in for
+		 * the hottest component combinations: a pool is owned by one group at most, and joining or leaving the group
+		 * costs one swap per pool. Adding grouped components while a view walks one of the pools is not supported;
+		 * record it in an EcsCommandBuffer instead. Requires StorageMode::ComponentPools.
+		 */
+		template <typename... Ts>
+		Ecs::Group<Ts...> Group() const
+		{
+			static_assert(sizeof...(Ts) > 1, "A group packs at least two pools.");
+			OWL_CORE_ASSERT(m_StorageMode == StorageMode::ComponentPools, "Groups require component pool storage.")
+
+			Signature types;
+			(types.set(m_ComponentManager->GetComponentType<std::remove_const_t<Ts>>()), ...);
+			return Ecs::Group<Ts...>(m_ComponentManager->AssureGroup(types), m_ComponentManager->GetComponentArray<std::remove_const_t<Ts>>()...);
+		}
+
+		/**
+		 * \brief Calls pFunc([entity,] components...) for every entity owning all of Ts.
+		 * Walks the chunk columns with archetype storage, or a View over the pools otherwise. Ts may be const qualified.
+		 * Filters, Previous<T> and tag filters only exist in pool storage, through View. In either storage, entities
+		 * carrying a tag are iterated through a system whose signature holds it.
+		 */
+		template <typename... Ts, typename Func>
+		void ForEach(Func&& pFunc)
+		{
+			static_assert(((ViewItem<Ts>::IsFetched && !ViewItem<Ts>::IsPublished && !IsTagComponent<ViewComponent<Ts>>) && ...),
+			              "ForEach only iterates stored components; use View for filters, Previous<T> and tags, or a system signature.");
+
+			if (m_StorageMode == StorageMode::Archetypes)
+				m_ArchetypeManager->ForEach<Ts...>({m_ComponentManager->GetComponentType<Ts>()...}, pFunc);
+			else
+				View<Ts...>().Each(pFunc);
+		}
+
+		/**
+		 * \brief Double-buffers T: besides the components, its pool keeps a published copy that PublishFrame updates
+		 * once per frame. Reading the published copy, through GetPreviousComponent or a Previous<T> view item,
+		 * is safe from other threads while systems write existing components of T, so render preparation can read
+		 * last frame's state while simulation writes this frame's. Adding or removing T, destroying entities that
+		 * have it, command buffer playback, streaming splices and pool sorting move and may reallocate the published
+		 * copy: readers must be done before any of them, as they must be before PublishFrame. Requires
+		 * StorageMode::ComponentPools.
+		 */
+		template <typename T>
+		void EnableDoubleBuffering() const
+		{
+			OWL_CORE_ASSERT(m_StorageMode == StorageMode::ComponentPools, "Double buffering requires component pool storage.")
+
+			m_ComponentManager->EnableDoubleBuffering<T>();
+		}
+
+		/**
+		 * \brief T of pEntity as of the last PublishFrame. T must be double-buffered.
+		 */
+		template <typename T>
+		const T& GetPreviousComponent(const Entity pEntity) const
+		{
+			return m_ComponentManager->GetComponentArray<T>().GetPublishedData(pEntity);
+		}
+
+		/**
+		 * \brief Publishes this frame's writes to the double-buffered components. Called by Update once the systems are
+		 * done; readers of the published buffers must not overlap it, nor any structural change.
+		 */
+		void PublishFrame() const { m_ComponentManager->PublishDoubleBuffered(); }
+
 		template <typename T>
 		[[nodiscard]] ComponentType GetComponentType() const
 		{
 			return m_ComponentManager->GetComponentType<T>();
 		}
 
+		[[nodiscard]] StorageMode GetStorageMode() const { return m_StorageMode; }
+
+
+		/**
+		 * \brief Stores pValue as the single instance of T owned by the world, for global data such as time,
+		 * input or the active camera. Systems touching it declare so with ReadsResources/WritesResources.
+		 */
+		template <typename T>
+		T& InsertResource(T pValue) const
+		{
+			return m_ResourceManager->InsertResource<T>(std::move(pValue));
+		}
+
+		/**
+		 * \brief Constructs the T resource in place, for types that cannot be moved.
+		 */
+		template <typename T, typename... Args>
+		T& EmplaceResource(Args&&... pArgs) const
+		{
+			return m_ResourceManager->EmplaceResource<T>(std::forward<Args>(pArgs)...);
+		}
+
+		template <typename T>
+		[[nodiscard]] T& GetResource() const
+		{
+			return m_ResourceManager->GetResource<T>();
+		}
+
+		/**
+		 * \brief Like GetResource, but returns nullptr when no T was inserted.
+		 */
+		template <typename T>
+		[[nodiscard]] T* TryGetResource() const
+		{
+			return m_ResourceManager->TryGetResource<T>();
+		}
+
+		/**
+		 * \brief A handle to the T resource that systems can keep and dereference without any lookup.
+		 */
+		template <typename T>
+		[[nodiscard]] ResourceHandle<T> GetResourceHandle() const
+		{
+			return ResourceHandle<T>(&GetResource<T>());
+		}
+
 
 		template <typename T>
 		std::shared_ptr<T> RegisterSystem()
@@ -72,9 +348,107 @@ namespace Owl::Ecs
 			m_SystemManager->SetSignature<T>(pSignature);
 		}
 
+		/**
+		 * \brief Updates every registered system, then publishes the double-buffered components and flushes the
+		 * observers. Systems with disjoint declared access run in parallel.
+		 */
+		void Update(Timestep pTimestep) const;
+
+
+		/**
+		 * \brief Calls pCallback at every flush with the entities on which T raised pEvent since the previous one.
+		 * Set events are derived from change detection, so they require StorageMode::ComponentPools and are not
+		 * available for tags. A Set observer reports every component written after its registration, including those
+		 * added earlier, except the ones the same flush reports as added.
+		 */
+		template <typename T>
+		ObserverId Observe(const ComponentEvent pEvent, ObserverCallback pCallback) const
+		{
+			OWL_CORE_ASSERT(pEvent != ComponentEvent::Set || (!IsTagComponent<T> && m_StorageMode == StorageMode::ComponentPools),
+			                "Set events require a component pool.")
+
+			// Writes stamped before the registration belong to the previous tick and are not reported as set.
+			return m_ObserverManager->AddObserver(m_ComponentManager->GetComponentType<T>(), pEvent, std::move(pCallback),
+			                                      m_ComponentManager->AdvanceChangeTick());
+		}
+
+		void RemoveObserver(const ObserverId pId) const { m_ObserverManager->RemoveObserver(pId); }
+
+		/**
+		 * \brief Delivers the pending component events to the observers. Called by Update; call it directly when
+		 * structural changes happen outside of it.
+		 */
+		void FlushObservers() const { m_ObserverManager->Flush(*m_ComponentManager); }
+
+		/**
+		 * \brief The tick components are currently stamped with when added or obtained mutably.
+		 * Change detection is tracked by the component pools; archetype storage does not stamp components.
+		 */
+		[[nodiscard]] uint32_t GetChangeTick() const { return m_ComponentManager->GetChangeTick(); }
+
+		/**
+		 * \brief Moves the change tick forward, for consumers outside of systems.
+		 * \return A tick to pass to View: components stamped after this call compare newer than it.
+		 */
+		uint32_t AdvanceChangeTick() const { return m_ComponentManager->AdvanceChangeTick(); }
+
 	private:
+		friend class EcsCommandBuffer;
+		friend class PoolSorter;
+		friend class WorldSnapshot;
+		friend class WorldStreamer;
+
+		StorageMode m_StorageMode = StorageMode::ComponentPools;
+		std::unique_ptr<ArchetypeManager> m_ArchetypeManager;
 		std::unique_ptr<ComponentManager> m_ComponentManager;
 		std::unique_ptr<EntityManager> m_EntityManager;
+		std::unique_ptr<ObserverManager> m_ObserverManager;
+		std::unique_ptr<ResourceManager> m_ResourceManager;
 		std::unique_ptr<SystemManager> m_SystemManager;
+
+		template <typename T>
+		ViewPool<T>& GetViewPool() const
+		{
+			if constexpr (IsViewTag<T>)
+			{
+				static TagPool tags;
+				return tags;
+			}
+			else
+			{
+				return m_ComponentManager->GetComponentArray<ViewComponent<T>>();
+			}
+		}
+
+		// Storage-only halves of AddComponent/RemoveComponent; the caller commits the signature.
+		// Tags own no pool, but still move the entity to its new archetype.
+		template <typename T>
+		void StoreComponent(const Entity pEntity, const ComponentType pType, T pComponent) const
+		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				m_ArchetypeManager->AddComponent<T>(pEntity, pType, std::move(pComponent));
+			else if constexpr (!IsTagComponent<T>)
+				m_ComponentManager->AddComponent<T>(pEntity, std::move(pComponent));
+		}
+
+		template <typename T>
+		void EraseComponent(const Entity pEntity, const ComponentType pType) const
+		{
+			if (m_StorageMode == StorageMode::Archetypes)
+				m_ArchetypeManager->RemoveComponent(pEntity, pType);
+			else if constexpr (!IsTagComponent<T>)
+				m_ComponentManager->RemoveComponent<T>(pEntity);
+		}
+
+		template <typename T>
+		void InsertComponents(const std::span<const Entity> pEntities, const T& pComponent) const
+		{
+			if constexpr (!IsTagComponent<T>)
+				m_ComponentManager->GetComponentArray<T>().InsertData(pEntities, pComponent);
+		}
+
+		void CommitCreatedEntities(std::span<const Entity> pEntities, Signature pSignature) const;
+		void CommitSignature(Entity pEntity, Signature pOldSignature, Signature pNewSignature) const;
+		void CommitAddedComponent(std::span<const Entity> pEntities, ComponentType pType) const;
 	};
 }
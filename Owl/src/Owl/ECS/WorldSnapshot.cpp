@@ -0,0 +1,475 @@
+﻿#include "opch.h"
+#include "WorldSnapshot.h"
+
+#include <cstring>
+
+#include "World.h"
+
+namespace Owl::Ecs
+{
+	namespace
+	{
+		constexpr uint32_t k_Magic = 0x534C574F; // "OWLS"
+		constexpr uint64_t k_ColumnAlignment = 64;
+
+		// File layout: Header, the handle of every slot, the free slot indices, the ColumnHeader table, then for
+		// each column its owners and its packed components, both starting on a k_ColumnAlignment boundary.
+		struct Header
+		{
+			uint32_t Magic;
+			uint32_t Version;
+			uint32_t SlotCount;
+			uint32_t FreeCount;
+			uint32_t ColumnCount;
+			uint32_t Reserved;
+			uint64_t FileSize;
+		};
+
+		struct ColumnHeader
+		{
+			uint64_t TypeKey;
+			uint32_t Size;
+			uint32_t Count;
+			uint64_t OwnersOffset;
+			uint64_t DataOffset;
+		};
+
+		constexpr uint64_t AlignUp(const uint64_t pOffset, const uint64_t pAlignment)
+		{
+			return (pOffset + pAlignment - 1) / pAlignment * pAlignment;
+		}
+
+		// Streams the image to a file, or appends it to a buffer when there is no file.
+		class SnapshotWriter
+		{
+		public:
+			explicit SnapshotWriter(const File& pFile)
+				: m_File(&pFile)
+			{
+			}
+
+			explicit SnapshotWriter(std::vector<uint8_t>& pBuffer)
+				: m_Buffer(&pBuffer)
+			{
+			}
+
+			void Write(const void* pData, const uint64_t pSize)
+			{
+				if (m_File)
+				{
+					uint64_t written = 0;
+					m_IsGood &= FilesSystem::TryWrite(*m_File, pSize, pData, &written) && written == pSize;
+				}
+				else if (pSize != 0)
+				{
+					const auto* bytes = static_cast<const uint8_t*>(pData);
+					m_Buffer->insert(m_Buffer->end(), bytes, bytes + pSize);
+				}
+				m_Offset += pSize;
+			}
+
+			void PadTo(const uint64_t pOffset)
+			{
+				static constexpr char zeros[k_ColumnAlignment]{};
+				Write(zeros, pOffset - m_Offset);
+			}
+
+			[[nodiscard]] bool IsGood() const { return m_IsGood; }
+			[[nodiscard]] uint64_t GetOffset() const { return m_Offset; }
+
+		private:
+			const File* m_File = nullptr;
+			std::vector<uint8_t>* m_Buffer = nullptr;
+			uint64_t m_Offset = 0;
+			bool m_IsGood = true;
+		};
+
+		// A column as it is saved: a pool's entities and data, or the owners of a tag with no data at all.
+		struct ColumnSource
+		{
+			ComponentLayout Layout;
+			std::span<const Entity> Owners;
+			const void* Data;
+		};
+
+		uint64_t GetTablesEnd(const uint32_t pSlotCount, const uint32_t pFreeCount)
+		{
+			const uint64_t entityTablesEnd = sizeof(Header) + (static_cast<uint64_t>(pSlotCount) + pFreeCount) * sizeof(uint32_t);
+			return AlignUp(entityTablesEnd, alignof(ColumnHeader));
+		}
+
+		// Every offset is known up front, so the image is written front to back in a single pass.
+		bool WriteImage(SnapshotWriter& pWriter, const std::span<const Entity> pHandles, const std::span<const uint32_t> pFreeIndices,
+		                const std::span<const ColumnSource> pSources)
+		{
+			Header header{k_Magic, WorldSnapshot::k_Version, static_cast<uint32_t>(pHandles.size()), static_cast<uint32_t>(pFreeIndices.size()),
+			              static_cast<uint32_t>(pSources.size()), 0, 0};
+			std::vector<ColumnHeader> columns;
+			columns.reserve(pSources.size());
+
+			uint64_t offset = GetTablesEnd(header.SlotCount, header.FreeCount) + pSources.size() * sizeof(ColumnHeader);
+			for (const ColumnSource& source : pSources)
+			{
+				const uint32_t count = static_cast<uint32_t>(source.Owners.size());
+				const uint64_t ownersOffset = AlignUp(offset, k_ColumnAlignment);
+				const uint64_t dataOffset = AlignUp(ownersOffset + count * sizeof(Entity), k_ColumnAlignment);
+
+				columns.push_back({source.Layout.TypeKey, source.Layout.Size, count, ownersOffset, dataOffset});
+				offset = dataOffset + static_cast<uint64_t>(count) * source.Layout.Size;
+			}
+			header.FileSize = offset;
+
+			pWriter.Write(&header, sizeof(Header));
+			pWriter.Write(pHandles.data(), pHandles.size_bytes());
+			pWriter.Write(pFreeIndices.data(), pFreeIndices.size_bytes());
+			pWriter.PadTo(GetTablesEnd(header.SlotCount, header.FreeCount));
+			pWriter.Write(columns.data(), columns.size() * sizeof(ColumnHeader));
+
+			for (size_t i = 0; i < pSources.size(); ++i)
+			{
+				pWriter.PadTo(columns[i].OwnersOffset);
+				pWriter.Write(pSources[i].Owners.data(), pSources[i].Owners.size_bytes());
+				pWriter.PadTo(columns[i].DataOffset);
+				pWriter.Write(pSources[i].Data, static_cast<uint64_t>(columns[i].Count) * columns[i].Size);
+			}
+
+			return pWriter.IsGood() && pWriter.GetOffset() == header.FileSize;
+		}
+	}
+
+	WorldSnapshot::~WorldSnapshot()
+	{
+		Close();
+	}
+
+	bool WorldSnapshot::Save(const World& pWorld, const char* pPath)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		if (pWorld.GetStorageMode() != StorageMode::ComponentPools)
+		{
+			OWL_CORE_ERROR("[WorldSnapshot] Snapshots require component pool storage.");
+			return false;
+		}
+
+		const std::span<const Entity> handles = pWorld.m_EntityManager->GetHandles();
+		const std::span<const uint32_t> freeIndices = pWorld.m_EntityManager->GetFreeIndices();
+
+		const ComponentManager& componentManager = *pWorld.m_ComponentManager;
+		std::vector<ColumnSource> sources;
+		for (uint32_t type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			const IComponentArray* pool = componentManager.GetComponentArray(static_cast<ComponentType>(type));
+			if (!pool || pool->GetSize() == 0)
+				continue;
+
+			if (!pool->GetLayout().IsTriviallyCopyable)
+			{
+				OWL_CORE_WARN("[WorldSnapshot] Skipping component type %u: it is not trivially copyable.", type);
+				continue;
+			}
+			sources.push_back({pool->GetLayout(), {pool->GetEntities().Data(), pool->GetSize()}, pool->GetRawData()});
+		}
+
+		// Tags have no pool, so their owners are gathered from the signatures in a single pass over the slots.
+		std::vector<std::vector<Entity>> tagOwners(MAX_COMPONENTS);
+		if (const Signature tags = componentManager.GetTagTypes(); tags.any())
+		{
+			for (uint32_t index = 0; index < handles.size(); ++index)
+			{
+				const Entity entity = handles[index];
+				if (GetEntityIndex(entity) != index)
+					continue;
+
+				const Signature entityTags = pWorld.m_EntityManager->GetSignature(entity) & tags;
+				for (uint32_t type = 0; type < MAX_COMPONENTS && entityTags.any(); ++type)
+				{
+					if (entityTags.test(type))
+						tagOwners[type].push_back(entity);
+				}
+			}
+
+			for (uint32_t type = 0; type < MAX_COMPONENTS; ++type)
+			{
+				if (!tagOwners[type].empty())
+					sources.push_back({componentManager.GetLayout(static_cast<ComponentType>(type)), tagOwners[type], nullptr});
+			}
+		}
+
+		File file;
+		if (!FilesSystem::TryOpen(pPath, FileModeWrite | FileModeNew, true, file))
+			return false;
+
+		SnapshotWriter writer(file);
+		const bool isWritten = WriteImage(writer, handles, freeIndices, sources);
+		FilesSystem::Close(file);
+
+		if (!isWritten)
+		{
+			OWL_CORE_ERROR("[WorldSnapshot] Error writing snapshot: '%s'", pPath);
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<uint8_t> WorldSnapshot::Encode(const World& pWorld, const std::span<const Entity> pEntities,
+	                                           const std::span<const EntityField> pEntityFields)
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(pWorld.GetStorageMode() == StorageMode::ComponentPools, "Snapshots require component pool storage.")
+
+		// The dense index of an entity in this set is its index in the image.
+		SparseSet locals;
+		locals.Insert(pEntities);
+
+		const ComponentManager& componentManager = *pWorld.m_ComponentManager;
+		std::vector<ColumnSource> sources;
+		std::vector<std::vector<Entity>> owners(MAX_COMPONENTS);
+		std::vector<std::vector<uint8_t>> data(MAX_COMPONENTS);
+
+		for (uint32_t type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			const ComponentType componentType = static_cast<ComponentType>(type);
+			const IComponentArray* pool = componentManager.GetComponentArray(componentType);
+			const ComponentLayout& layout = componentManager.GetLayout(componentType);
+			if (!componentManager.IsRegistered(componentType) || !(pool ? layout.IsTriviallyCopyable : layout.IsTag))
+				continue;
+
+			for (uint32_t local = 0; local < pEntities.size(); ++local)
+			{
+				const Entity entity = pEntities[local];
+				if (!pWorld.m_EntityManager->GetSignature(entity).test(type))
+					continue;
+
+				owners[type].push_back(MakeEntity(local, 0));
+				if (pool)
+				{
+					const auto* component = static_cast<const uint8_t*>(pool->GetRawData()) +
+						static_cast<size_t>(pool->GetEntities().IndexOf(entity)) * layout.Size;
+					data[type].insert(data[type].end(), component, component + layout.Size);
+				}
+			}
+
+			// References to entities of the image become image handles; the others cannot be kept.
+			for (const EntityField& field : pEntityFields)
+			{
+				if (field.TypeKey != layout.TypeKey)
+					continue;
+
+				for (size_t offset = field.Offset; offset < data[type].size(); offset += layout.Size)
+				{
+					Entity target;
+					std::memcpy(&target, data[type].data() + offset, sizeof(Entity));
+					const uint32_t local = target == NULL_ENTITY ? SparseSet::k_Invalid : locals.Find(target);
+					target = local != SparseSet::k_Invalid ? MakeEntity(local, 0) : NULL_ENTITY;
+					std::memcpy(data[type].data() + offset, &target, sizeof(Entity));
+				}
+			}
+
+			if (!owners[type].empty())
+				sources.push_back({layout, owners[type], pool ? data[type].data() : nullptr});
+		}
+
+		std::vector<Entity> handles(pEntities.size());
+		for (uint32_t local = 0; local < handles.size(); ++local)
+			handles[local] = MakeEntity(local, 0);
+
+		std::vector<uint8_t> image;
+		SnapshotWriter writer(image);
+		WriteImage(writer, handles, {}, sources);
+		return image;
+	}
+
+	bool WorldSnapshot::Load(World& pWorld, const char* pPath)
+	{
+		WorldSnapshot snapshot;
+		return snapshot.Open(pPath) && snapshot.LoadInto(pWorld);
+	}
+
+	bool WorldSnapshot::Open(const char* pPath)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		Close();
+		if (!FilesSystem::TryMap(pPath, m_File))
+			return false;
+
+		m_Image = {static_cast<const uint8_t*>(m_File.Data), m_File.Size};
+		return Parse(pPath);
+	}
+
+	bool WorldSnapshot::Open(const std::span<const uint8_t> pImage)
+	{
+		Close();
+		m_Image = pImage;
+		return Parse("<image>");
+	}
+
+	bool WorldSnapshot::Parse(const char* pName)
+	{
+		const uint8_t* bytes = m_Image.data();
+		const uint64_t size = m_Image.size();
+		const auto* header = reinterpret_cast<const Header*>(bytes);
+
+		bool isValid = size >= sizeof(Header) && reinterpret_cast<uintptr_t>(bytes) % alignof(Header) == 0 && header->Magic == k_Magic &&
+			header->Version == k_Version && header->FileSize == size && header->FreeCount <= header->SlotCount;
+
+		uint64_t tablesEnd = 0;
+		if (isValid)
+		{
+			tablesEnd = GetTablesEnd(header->SlotCount, header->FreeCount);
+			isValid = tablesEnd + static_cast<uint64_t>(header->ColumnCount) * sizeof(ColumnHeader) <= size;
+		}
+
+		if (isValid)
+		{
+			const auto* handles = reinterpret_cast<const Entity*>(bytes + sizeof(Header));
+			m_Handles = {handles, header->SlotCount};
+			m_FreeIndices = {reinterpret_cast<const uint32_t*>(handles + header->SlotCount), header->FreeCount};
+
+			const auto* columns = reinterpret_cast<const ColumnHeader*>(bytes + tablesEnd);
+			m_Columns.reserve(header->ColumnCount);
+			for (uint32_t i = 0; i < header->ColumnCount && isValid; ++i)
+			{
+				const ColumnHeader& column = columns[i];
+				isValid = column.OwnersOffset % k_ColumnAlignment == 0 && column.DataOffset % k_ColumnAlignment == 0 &&
+					column.OwnersOffset + static_cast<uint64_t>(column.Count) * sizeof(Entity) <= size &&
+					column.DataOffset + static_cast<uint64_t>(column.Count) * column.Size <= size;
+
+				m_Columns.push_back({column.TypeKey, column.Size, column.Count, reinterpret_cast<const Entity*>(bytes + column.OwnersOffset),
+				                     bytes + column.DataOffset});
+			}
+		}
+
+		if (!isValid)
+		{
+			OWL_CORE_ERROR("[WorldSnapshot] '%s' is not a version %u snapshot.", pName, k_Version);
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void WorldSnapshot::Close()
+	{
+		if (m_File.Data)
+			FilesSystem::Unmap(m_File);
+		m_File = {};
+		m_Image = {};
+		m_Handles = {};
+		m_FreeIndices = {};
+		m_Columns.clear();
+	}
+
+	bool WorldSnapshot::LoadInto(World& pWorld) const
+	{
+		OWL_PROFILE_FUNCTION();
+		OWL_CORE_ASSERT(IsOpen(), "Loading a snapshot that is not open.")
+
+		if (pWorld.GetStorageMode() != StorageMode::ComponentPools)
+		{
+			OWL_CORE_ERROR("[WorldSnapshot] Snapshots require component pool storage.");
+			return false;
+		}
+		if (pWorld.m_EntityManager->GetLivingEntityCount() != 0)
+		{
+			OWL_CORE_ERROR("[WorldSnapshot] Snapshots can only be loaded into a world without living entities.");
+			return false;
+		}
+
+		// Validate everything and build the signatures before the world is touched.
+		for (const uint32_t index : m_FreeIndices)
+		{
+			if (index >= m_Handles.size() || GetEntityIndex(m_Handles[index]) != ENTITY_INDEX_MASK)
+			{
+				OWL_CORE_ERROR("[WorldSnapshot] Corrupted free slot list.");
+				return false;
+			}
+		}
+
+		ComponentManager& componentManager = *pWorld.m_ComponentManager;
+		std::vector<Signature> signatures(m_Handles.size());
+		std::vector<std::pair<const Column*, IComponentArray*>> matches;
+
+		for (const Column& column : m_Columns)
+		{
+			const ComponentLayout* layout = nullptr;
+			ComponentType type = 0;
+			for (uint32_t candidate = 0; candidate < MAX_COMPONENTS && !layout; ++candidate)
+			{
+				const ComponentType candidateType = static_cast<ComponentType>(candidate);
+				if (componentManager.IsRegistered(candidateType) && componentManager.GetLayout(candidateType).TypeKey == column.TypeKey)
+				{
+					type = candidateType;
+					layout = &componentManager.GetLayout(candidateType);
+				}
+			}
+
+			if (!layout || layout->Size != column.Size || !(layout->IsTag || layout->IsTriviallyCopyable))
+			{
+				OWL_CORE_WARN("[WorldSnapshot] Skipping column %016llx: no matching trivially copyable component is registered.",
+				              static_cast<unsigned long long>(column.TypeKey));
+				continue;
+			}
+
+			for (uint32_t i = 0; i < column.Count; ++i)
+			{
+				const Entity owner = column.Owners[i];
+				const uint32_t index = GetEntityIndex(owner);
+				if (index >= m_Handles.size() || m_Handles[index] != owner || signatures[index].test(type))
+				{
+					OWL_CORE_ERROR("[WorldSnapshot] Corrupted column %016llx.", static_cast<unsigned long long>(column.TypeKey));
+					return false;
+				}
+				signatures[index].set(type);
+			}
+
+			if (!layout->IsTag)
+				matches.emplace_back(&column, componentManager.GetComponentArray(type));
+		}
+
+		pWorld.m_EntityManager->Restore(m_Handles, m_FreeIndices);
+		for (const auto& [column, pool] : matches)
+			pool->InsertRawData({column->Owners, column->Count}, column->Data);
+
+		// Systems are told once per distinct signature rather than once per entity. Neighbouring entities usually
+		// share their signature, so the map is only searched when it changes.
+		std::unordered_map<Signature, std::vector<Entity>> entitiesBySignature;
+		std::vector<Entity>* group = nullptr;
+		Signature groupSignature;
+		for (uint32_t index = 0; index < m_Handles.size(); ++index)
+		{
+			const Entity entity = m_Handles[index];
+			if (GetEntityIndex(entity) != index)
+				continue;
+
+			if (!group || signatures[index] != groupSignature)
+			{
+				groupSignature = signatures[index];
+				group = &entitiesBySignature[groupSignature];
+			}
+			pWorld.m_EntityManager->SetSignature(entity, groupSignature);
+			group->push_back(entity);
+		}
+
+		for (const auto& [signature, entities] : entitiesBySignature)
+			pWorld.CommitCreatedEntities(entities, signature);
+
+		return true;
+	}
+
+	uint32_t WorldSnapshot::GetLivingEntityCount() const
+	{
+		return static_cast<uint32_t>(m_Handles.size() - m_FreeIndices.size());
+	}
+
+	const WorldSnapshot::Column* WorldSnapshot::FindColumn(const uint64_t pTypeKey, const size_t pSize) const
+	{
+		for (const Column& column : m_Columns)
+		{
+			if (column.TypeKey == pTypeKey && column.Size == pSize)
+				return &column;
+		}
+		return nullptr;
+	}
+}
@@ -0,0 +1,136 @@
+﻿#pragma once
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "ComponentArray.h"
+#include "Ecs.h"
+#include "Owl/Platform/FilesSystem.h"
+
+namespace Owl::Ecs
+{
+	/**
+	 * \brief An Entity stored inside a trivially copyable component, so that it can be rewritten when entities are
+	 * saved and loaded under other handles.
+	 */
+	struct EntityField
+	{
+		uint64_t TypeKey;
+		uint32_t Offset;
+
+		template <typename T>
+		static EntityField Create(Entity T::* pMember)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "Entity fields belong to snapshot components.");
+
+			const T component{};
+			const auto* base = reinterpret_cast<const uint8_t*>(&component);
+			const auto* member = reinterpret_cast<const uint8_t*>(&(component.*pMember));
+			return {GetStableTypeKey<T>(), static_cast<uint32_t>(member - base)};
+		}
+	};
+
+	/**
+	 * \brief Versioned binary image of a World: its entity slots and one packed column per component pool.
+	 * Saving writes the pools straight from their storage in one streaming pass. Opening maps the file, so
+	 * columns can be read in place through GetComponents, or bulk copied into a World with LoadInto.
+	 * Only trivially copyable components are stored, identified by GetStableTypeKey, and only worlds using
+	 * StorageMode::ComponentPools are supported. Tags are saved as columns of owners without data.
+	 */
+	class WorldSnapshot
+	{
+	public:
+		static constexpr uint32_t k_Version = 1;
+
+		WorldSnapshot() = default;
+		~WorldSnapshot();
+
+		WorldSnapshot(const WorldSnapshot&) = delete;
+		WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+		/**
+		 * \brief Writes every entity of pWorld and the pools of its trivially copyable components to pPath.
+		 * \return True if written successfully; otherwise false.
+		 */
+		static bool Save(const World& pWorld, const char* pPath);
+
+		/**
+		 * \brief Encodes pEntities alone into an in-memory image with the same layout as a file, pEntities[i] being
+		 * stored as entity i. The listed entity fields are rewritten to the image handles, or to NULL_ENTITY when
+		 * they reference an entity outside of pEntities.
+		 * \param pEntities Living, distinct entities of pWorld.
+		 */
+		static std::vector<uint8_t> Encode(const World& pWorld, std::span<const Entity> pEntities, std::span<const EntityField> pEntityFields = {});
+
+		/**
+		 * \brief Opens pPath and loads it into pWorld; see LoadInto.
+		 */
+		static bool Load(World& pWorld, const char* pPath);
+
+		/**
+		 * \brief Maps pPath and validates its layout. Column data is only paged in when touched.
+		 * \return True if the file is a snapshot of this version; otherwise false.
+		 */
+		bool Open(const char* pPath);
+
+		/**
+		 * \brief Opens an image in memory, such as one made by Encode. The image must outlive the snapshot.
+		 */
+		bool Open(std::span<const uint8_t> pImage);
+		void Close();
+
+		/**
+		 * \brief Gives pWorld the entities of the snapshot, handles and generations included, and copies each
+		 * column into the pool registered under the same key. Columns without a matching pool are skipped.
+		 * \param pWorld An initialized World without living entities.
+		 * \return True if loaded; otherwise false and pWorld is left untouched.
+		 */
+		bool LoadInto(World& pWorld) const;
+
+		[[nodiscard]] bool IsOpen() const { return !m_Image.empty(); }
+		[[nodiscard]] uint32_t GetLivingEntityCount() const;
+
+		/**
+		 * \brief The stored components of type T, read in place from the mapped file; empty if T was not saved.
+		 */
+		template <typename T>
+		[[nodiscard]] std::span<const T> GetComponents() const
+		{
+			static_assert(!IsTagComponent<T>, "Tag components have no data; use GetOwners.");
+
+			const Column* column = FindColumn(GetStableTypeKey<T>(), sizeof(T));
+			return column ? std::span<const T>(static_cast<const T*>(column->Data), column->Count) : std::span<const T>();
+		}
+
+		/**
+		 * \brief The entity owning each element of GetComponents<T>().
+		 */
+		template <typename T>
+		[[nodiscard]] std::span<const Entity> GetOwners() const
+		{
+			const Column* column = FindColumn(GetStableTypeKey<T>(), ComponentLayout::Create<T>().Size);
+			return column ? std::span<const Entity>(column->Owners, column->Count) : std::span<const Entity>();
+		}
+
+	private:
+		friend class WorldStreamer;
+
+		struct Column
+		{
+			uint64_t TypeKey;
+			uint32_t Size;
+			uint32_t Count;
+			const Entity* Owners;
+			const void* Data;
+		};
+
+		MappedFile m_File{};
+		std::span<const uint8_t> m_Image;
+		std::span<const Entity> m_Handles;
+		std::span<const uint32_t> m_FreeIndices;
+		std::vector<Column> m_Columns;
+
+		bool Parse(const char* pName);
+		[[nodiscard]] const Column* FindColumn(uint64_t pTypeKey, size_t pSize) const;
+	};
+}
@@ -0,0 +1,338 @@
+﻿#include "opch.h"
+#include "WorldStreamer.h"
+
+#include <cstring>
+
+#include "World.h"
+
+namespace Owl::Ecs
+{
+	namespace
+	{
+		bool WriteFile(const std::string& pPath, const std::vector<uint8_t>& pImage)
+		{
+			File file;
+			if (!FilesSystem::TryOpen(pPath.c_str(), FileModeWrite | FileModeNew, true, file))
+				return false;
+
+			uint64_t written = 0;
+			const bool isWritten = FilesSystem::TryWrite(file, pImage.size(), pImage.data(), &written) && written == pImage.size();
+			FilesSystem::Close(file);
+			return isWritten;
+		}
+	}
+
+	WorldStreamer::WorldStreamer(World& pWorld, const uint32_t pThreadCount)
+		: m_World(&pWorld), m_ThreadPool(CreateScope<ThreadPool>(pThreadCount))
+	{
+		OWL_CORE_ASSERT(pWorld.GetStorageMode() == StorageMode::ComponentPools, "Streaming requires component pool storage.")
+	}
+
+	WorldStreamer::~WorldStreamer()
+	{
+		Wait();
+	}
+
+	void WorldStreamer::AddToCell(const CellId pCell, const std::span<const Entity> pEntities)
+	{
+		Cell& cell = m_Cells[pCell];
+
+		OWL_CORE_ASSERT(cell.State != CellState::Loading, "Adding entities to a cell that is still loading.")
+
+		cell.State = CellState::Loaded;
+		cell.Entities.insert(cell.Entities.end(), pEntities.begin(), pEntities.end());
+	}
+
+	void WorldStreamer::UnloadCell(const CellId pCell, std::string pPath)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		const auto found = m_Cells.find(pCell);
+		if (found == m_Cells.end() || found->second.State != CellState::Loaded)
+		{
+			OWL_CORE_WARN("[WorldStreamer] Cell %llu is not loaded.", static_cast<unsigned long long>(pCell));
+			return;
+		}
+
+		// Entities destroyed by other means since they joined the cell are left out.
+		Cell& cell = found->second;
+		std::erase_if(cell.Entities, [this](const Entity pEntity) { return !m_World->IsAlive(pEntity); });
+
+		auto image = std::make_shared<std::vector<uint8_t>>(WorldSnapshot::Encode(*m_World, cell.Entities, m_EntityFields));
+		for (const Entity entity : cell.Entities)
+			m_World->DestroyEntity(entity);
+
+		cell.Entities.clear();
+		cell.State = CellState::Unloaded;
+
+		auto written = std::make_shared<std::promise<void>>();
+		cell.Write = written->get_future().share();
+		Submit([image = std::move(image), path = std::move(pPath), written]
+		{
+			if (!WriteFile(path, *image))
+				OWL_CORE_ERROR("[WorldStreamer] Error writing cell: '%s'", path.c_str());
+			written->set_value();
+		});
+	}
+
+	void WorldStreamer::RequestLoad(const CellId pCell, std::string pPath)
+	{
+		Cell& cell = m_Cells[pCell];
+		if (cell.State != CellState::Unloaded)
+			return;
+
+		cell.State = CellState::Loading;
+		Submit([this, pCell, path = std::move(pPath), components = GetComponentTable(), fields = m_EntityFields, write = cell.Write]
+		{
+			if (write.valid())
+				write.wait();
+
+			Scope<DecodedCell> decoded = Decode(pCell, path, components, fields);
+			std::lock_guard lock(m_Mutex);
+			m_Decoded.push_back(std::move(decoded));
+		});
+	}
+
+	uint32_t WorldStreamer::SpliceLoadedCells(const uint32_t pMaxCells)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		uint32_t spliced = 0;
+		while (spliced < pMaxCells)
+		{
+			Scope<DecodedCell> decoded;
+			{
+				std::lock_guard lock(m_Mutex);
+				if (m_Decoded.empty())
+					break;
+
+				decoded = std::move(m_Decoded.front());
+				m_Decoded.pop_front();
+			}
+
+			Cell& cell = m_Cells[decoded->Id];
+			if (!decoded->IsValid)
+			{
+				OWL_CORE_ERROR("[WorldStreamer] Could not load cell %llu.", static_cast<unsigned long long>(decoded->Id));
+				cell.State = CellState::Unloaded;
+				continue;
+			}
+
+			Splice(*decoded, cell.Entities);
+			cell.State = CellState::Loaded;
+			++spliced;
+		}
+		return spliced;
+	}
+
+	void WorldStreamer::Wait()
+	{
+		std::unique_lock lock(m_Mutex);
+		m_Condition.wait(lock, [this] { return m_PendingJobs == 0; });
+	}
+
+	bool WorldStreamer::IsLoaded(const CellId pCell) const
+	{
+		const auto found = m_Cells.find(pCell);
+		return found != m_Cells.end() && found->second.State == CellState::Loaded;
+	}
+
+	bool WorldStreamer::IsLoading(const CellId pCell) const
+	{
+		const auto found = m_Cells.find(pCell);
+		return found != m_Cells.end() && found->second.State == CellState::Loading;
+	}
+
+	std::span<const Entity> WorldStreamer::GetEntities(const CellId pCell) const
+	{
+		const auto found = m_Cells.find(pCell);
+		return found != m_Cells.end() ? std::span<const Entity>(found->second.Entities) : std::span<const Entity>();
+	}
+
+	void WorldStreamer::Submit(std::function<void()> pJob)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			++m_PendingJobs;
+		}
+
+		m_ThreadPool->Submit([this, job = std::move(pJob)]
+		{
+			job();
+
+			std::lock_guard lock(m_Mutex);
+			--m_PendingJobs;
+			m_Condition.notify_all();
+		});
+	}
+
+	WorldStreamer::ComponentTable WorldStreamer::GetComponentTable() const
+	{
+		const ComponentManager& componentManager = *m_World->m_ComponentManager;
+
+		ComponentTable table{};
+		for (uint32_t type = 0; type < MAX_COMPONENTS; ++type)
+		{
+			const ComponentType componentType = static_cast<ComponentType>(type);
+			if (!componentManager.IsRegistered(componentType))
+				continue;
+
+			table.Registered.set(type);
+			table.Layouts[type] = componentManager.GetLayout(componentType);
+		}
+		return table;
+	}
+
+	void WorldStreamer::Splice(DecodedCell& pCell, std::vector<Entity>& pEntities) const
+	{
+		OWL_PROFILE_FUNCTION();
+
+		std::vector<Entity> handles(pCell.SlotCount, NULL_ENTITY);
+		pEntities.resize(pCell.Slots.size());
+
+		size_t first = 0;
+		for (const auto& [signature, count] : pCell.Groups)
+		{
+			const std::span<Entity> group(pEntities.data() + first, count);
+			m_World->m_EntityManager->CreateEntities(group, signature);
+			for (uint32_t i = 0; i < count; ++i)
+				handles[pCell.Slots[first + i]] = group[i];
+			first += count;
+		}
+
+		std::vector<Entity> owners;
+		for (StagedColumn& column : pCell.Columns)
+		{
+			owners.resize(column.Slots.size());
+			for (size_t i = 0; i < owners.size(); ++i)
+				owners[i] = handles[column.Slots[i]];
+
+			for (const uint32_t fieldOffset : column.FieldOffsets)
+			{
+				for (size_t offset = fieldOffset; offset < column.Data.size(); offset += column.Size)
+				{
+					Entity target;
+					std::memcpy(&target, column.Data.data() + offset, sizeof(Entity));
+					target = target != NULL_ENTITY ? handles[target] : NULL_ENTITY;
+					std::memcpy(column.Data.data() + offset, &target, sizeof(Entity));
+				}
+			}
+
+			m_World->m_ComponentManager->GetComponentArray(column.Type)->InsertRawData(owners, column.Data.data());
+		}
+
+		first = 0;
+		for (const auto& [signature, count] : pCell.Groups)
+		{
+			m_World->CommitCreatedEntities({pEntities.data() + first, count}, signature);
+			first += count;
+		}
+	}
+
+	Scope<WorldStreamer::DecodedCell> WorldStreamer::Decode(const CellId pCell, const std::string& pPath, const ComponentTable& pComponents,
+	                                                        const std::vector<EntityField>& pEntityFields)
+	{
+		OWL_PROFILE_FUNCTION();
+
+		auto cell = CreateScope<DecodedCell>();
+		cell->Id = pCell;
+
+		WorldSnapshot snapshot;
+		if (!snapshot.Open(pPath.c_str()))
+			return cell;
+
+		const std::span<const Entity> handles = snapshot.m_Handles;
+		cell->SlotCount = static_cast<uint32_t>(handles.size());
+		std::vector<Signature> signatures(handles.size());
+
+		for (const WorldSnapshot::Column& column : snapshot.m_Columns)
+		{
+			const ComponentLayout* layout = nullptr;
+			ComponentType type = 0;
+			for (uint32_t candidate = 0; candidate < MAX_COMPONENTS && !layout; ++candidate)
+			{
+				if (pComponents.Registered.test(candidate) && pComponents.Layouts[candidate].TypeKey == column.TypeKey)
+				{
+					type = static_cast<ComponentType>(candidate);
+					layout = &pComponents.Layouts[candidate];
+				}
+			}
+
+			if (!layout || layout->Size != column.Size || !(layout->IsTag || layout->IsTriviallyCopyable))
+			{
+				OWL_CORE_WARN("[WorldStreamer] Skipping column %016llx of '%s': no matching trivially copyable component is registered.",
+				              static_cast<unsigned long long>(column.TypeKey), pPath.c_str());
+				continue;
+			}
+
+			StagedColumn staged;
+			staged.Type = type;
+			staged.Size = column.Size;
+			staged.Slots.reserve(column.Count);
+			for (uint32_t i = 0; i < column.Count; ++i)
+			{
+				const Entity owner = column.Owners[i];
+				const uint32_t index = GetEntityIndex(owner);
+				if (index >= handles.size() || handles[index] != owner || signatures[index].test(type))
+				{
+					OWL_CORE_ERROR("[WorldStreamer] Corrupted column %016llx in '%s'.", static_cast<unsigned long long>(column.TypeKey), pPath.c_str());
+					return cell;
+				}
+				signatures[index].set(type);
+				staged.Slots.push_back(index);
+			}
+
+			if (layout->IsTag)
+				continue;
+
+			// Copying the column out is what pages the file in, on this thread rather than the one splicing.
+			const auto* data = static_cast<const uint8_t*>(column.Data);
+			staged.Data.assign(data, data + static_cast<size_t>(column.Count) * column.Size);
+
+			for (const EntityField& field : pEntityFields)
+			{
+				if (field.TypeKey != column.TypeKey)
+					continue;
+
+				staged.FieldOffsets.push_back(field.Offset);
+				for (size_t offset = field.Offset; offset < staged.Data.size(); offset += column.Size)
+				{
+					Entity target;
+					std::memcpy(&target, staged.Data.data() + offset, sizeof(Entity));
+					const uint32_t index = GetEntityIndex(target);
+					target = target != NULL_ENTITY && index < handles.size() && handles[index] == target ? index : NULL_ENTITY;
+					std::memcpy(staged.Data.data() + offset, &target, sizeof(Entity));
+				}
+			}
+
+			cell->Columns.push_back(std::move(staged));
+		}
+
+		// Neighbouring entities usually share their signature, so the map is only searched when it changes.
+		std::unordered_map<Signature, std::vector<uint32_t>> slotsBySignature;
+		std::vector<uint32_t>* group = nullptr;
+		Signature groupSignature;
+		for (uint32_t index = 0; index < handles.size(); ++index)
+		{
+			if (GetEntityIndex(handles[index]) != index)
+				continue;
+
+			if (!group || signatures[index] != groupSignature)
+			{
+				groupSignature = signatures[index];
+				group = &slotsBySignature[groupSignature];
+			}
+			group->push_back(index);
+		}
+
+		cell->Slots.reserve(handles.size());
+		for (const auto& [signature, slots] : slotsBySignature)
+		{
+			cell->Slots.insert(cell->Slots.end(), slots.begin(), slots.end());
+			cell->Groups.emplace_back(signature, static_cast<uint32_t>(slots.size()));
+		}
+
+		cell->IsValid = true;
+		return cell;
+	}
+}
@@ -0,0 +1,150 @@
+﻿#pragma once
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ComponentArray.h"
+#include "Ecs.h"
+#include "WorldSnapshot.h"
+#include "Owl/Core/Base.h"
+#include "Owl/Core/ThreadPool.h"
+
+namespace Owl::Ecs
+{
+	using CellId = uint64_t;
+
+	/**
+	 * \brief Streams cells of entities in and out of a World, so a map larger than memory only keeps the cells
+	 * around the player resident. Cells are stored as snapshot images. Unloading encodes the cell on the calling
+	 * thread and writes it to disk in the background. Loading maps, validates and decodes the file in the
+	 * background, so the calling thread is only left with splicing the decoded columns into the pools.
+	 * Loaded entities get new handles, and registered entity fields are remapped to them.
+	 * Like WorldSnapshot, only trivially copyable components and tags are streamed, and the world must use
+	 * StorageMode::ComponentPools. Every call is made from the thread owning the world.
+	 */
+	class WorldStreamer
+	{
+	public:
+		/**
+		 * \param pThreadCount Number of background workers.
+		 */
+		explicit WorldStreamer(World& pWorld, uint32_t pThreadCount = 1);
+		~WorldStreamer();
+
+		WorldStreamer(const WorldStreamer&) = delete;
+		WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+		/**
+		 * \brief Declares an Entity member of T to remap when cells are saved and loaded. References to entities
+		 * outside of the cell become NULL_ENTITY.
+		 */
+		template <typename T>
+		void AddEntityField(Entity T::* pMember)
+		{
+			m_EntityFields.push_back(EntityField::Create(pMember));
+		}
+
+		/**
+		 * \brief Makes pEntities part of pCell, which becomes loaded if it was not.
+		 */
+		void AddToCell(CellId pCell, std::span<const Entity> pEntities);
+
+		/**
+		 * \brief Destroys the entities of pCell once they are encoded; the image is written to pPath in the background.
+		 */
+		void UnloadCell(CellId pCell, std::string pPath);
+
+		/**
+		 * \brief Starts reading and decoding pCell from pPath in the background, after any pending write of the cell.
+		 * The entities only exist once SpliceLoadedCells has added the cell to the world.
+		 */
+		void RequestLoad(CellId pCell, std::string pPath);
+
+		/**
+		 * \brief Adds up to pMaxCells decoded cells to the world. Call once per frame; splicing is bounded by the
+		 * size of the cells, as everything else was done in the background.
+		 * \return The number of cells added.
+		 */
+		uint32_t SpliceLoadedCells(uint32_t pMaxCells = 1);
+
+		/**
+		 * \brief Blocks until every background read and write is done.
+		 */
+		void Wait();
+
+		[[nodiscard]] bool IsLoaded(CellId pCell) const;
+		[[nodiscard]] bool IsLoading(CellId pCell) const;
+		[[nodiscard]] std::span<const Entity> GetEntities(CellId pCell) const;
+
+	private:
+		enum class CellState
+		{
+			Unloaded,
+			Loading,
+			Loaded
+		};
+
+		struct Cell
+		{
+			CellState State = CellState::Unloaded;
+			std::vector<Entity> Entities;
+			std::shared_future<void> Write;
+		};
+
+		// What the workers need to know of the registered components, copied when a load is requested.
+		struct ComponentTable
+		{
+			Signature Registered;
+			std::array<ComponentLayout, MAX_COMPONENTS> Layouts;
+		};
+
+		// A column decoded by a worker. Owners and entity fields hold slot indices of the image until spliced.
+		struct StagedColumn
+		{
+			ComponentType Type = 0;
+			uint32_t Size = 0;
+			std::vector<uint32_t> Slots;
+			std::vector<uint8_t> Data;
+			std::vector<uint32_t> FieldOffsets;
+		};
+
+		struct DecodedCell
+		{
+			CellId Id;
+			bool IsValid = false;
+			uint32_t SlotCount = 0;
+			// The living slots, grouped by signature; Groups holds the signature and size of each group in order.
+			std::vector<uint32_t> Slots;
+			std::vector<std::pair<Signature, uint32_t>> Groups;
+			std::vector<StagedColumn> Columns;
+		};
+
+		World* m_World;
+		std::vector<EntityField> m_EntityFields;
+		std::unordered_map<CellId, Cell> m_Cells;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::deque<Scope<DecodedCell>> m_Decoded;
+		uint32_t m_PendingJobs = 0;
+
+		// Last, so the workers are joined before anything they touch is destroyed.
+		Scope<ThreadPool> m_ThreadPool;
+
+		void Submit(std::function<void()> pJob);
+		[[nodiscard]] ComponentTable GetComponentTable() const;
+		void Splice(DecodedCell& pCell, std::vector<Entity>& pEntities) const;
+
+		static Scope<DecodedCell> Decode(CellId pCell, const std::string& pPath, const ComponentTable& pComponents,
+		                                 const std::vector<EntityField>& pEntityFields);
+	};
+}
@@ -312,6 +312,6 @@ namespace Owl
 			return pValue;
 		}
 
-		float Data[16];
+		float Data[16]{};
 	};
 }
@@ -10,6 +10,7 @@ namespace Owl
 		MemoryTagPlatform,
 		MemoryTagRenderer,
 		MemoryTagTexture,
+		MemoryTagEcs,
 
 		MemoryTagMaxTags
 	};
@@ -35,6 +36,7 @@ namespace Owl
 			"PLATFORM   ",
 			"RENDERER   ",
 			"TEXTURE    ",
+			"ECS        ",
 		};
 	};
 }
@@ -3,6 +3,15 @@
 #include <fstream>
 #include <iostream>
 
+#ifdef OWL_PLATFORM_WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Owl
 {
 	bool FilesSystem::Exist(const char* pPath)
@@ -116,4 +125,90 @@ namespace Owl
 
 		return true;
 	}
+
+	bool FilesSystem::TryMap(const char* pPath, MappedFile& pOutFile)
+	{
+		pOutFile = {};
+
+#ifdef OWL_PLATFORM_WINDOWS
+		const HANDLE file = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			OWL_CORE_ERROR("[FilesSystem] Error opening file: '%s'", pPath);
+			return false;
+		}
+
+		// Empty files cannot be mapped.
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			OWL_CORE_ERROR("[FilesSystem] Error mapping empty file: '%s'", pPath);
+			return false;
+		}
+
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!data)
+		{
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			OWL_CORE_ERROR("[FilesSystem] Error mapping file: '%s'", pPath);
+			return false;
+		}
+
+		pOutFile.Data = data;
+		pOutFile.Size = static_cast<uint64_t>(size.QuadPart);
+		pOutFile.FileHandle = file;
+		pOutFile.MappingHandle = mapping;
+#else
+		const int file = open(pPath, O_RDONLY);
+		if (file < 0)
+		{
+			OWL_CORE_ERROR("[FilesSystem] Error opening file: '%s'", pPath);
+			return false;
+		}
+
+		// Empty files cannot be mapped.
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			close(file);
+			OWL_CORE_ERROR("[FilesSystem] Error mapping empty file: '%s'", pPath);
+			return false;
+		}
+
+		// The mapping outlives the descriptor, so no handle is kept.
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (data == MAP_FAILED)
+		{
+			OWL_CORE_ERROR("[FilesSystem] Error mapping file: '%s'", pPath);
+			return false;
+		}
+
+		pOutFile.Data = data;
+		pOutFile.Size = static_cast<uint64_t>(status.st_size);
+#endif
+
+		return true;
+	}
+
+	void FilesSystem::Unmap(MappedFile& pFile)
+	{
+		if (!pFile.Data)
+			return;
+
+#ifdef OWL_PLATFORM_WINDOWS
+		UnmapViewOfFile(pFile.Data);
+		CloseHandle(pFile.MappingHandle);
+		CloseHandle(pFile.FileHandle);
+#else
+		munmap(const_cast<void*>(pFile.Data), static_cast<size_t>(pFile.Size));
+#endif
+
+		pFile = {};
+	}
 }
@@ -11,6 +11,17 @@ namespace Owl
 		bool IsValid;
 	};
 
+	/**
+	 * \brief A file mapped read only into memory. The handles are only kept on Windows.
+	 */
+	struct MappedFile
+	{
+		const void* Data;
+		uint64_t Size;
+		void* FileHandle;
+		void* MappingHandle;
+	};
+
 	enum FileModes
 	{
 		FileModeRead = 0x1,
@@ -95,5 +106,19 @@ namespace Owl
 		 * \return True if opened successfully; otherwise false.
 		 */
 		static bool TryWrite(const File& pFile, uint64_t pDataSize, const void* pData, uint64_t* pOutBytesWritten);
+
+		/**
+		 * \brief Maps the whole file located at path read only into memory. Pages are loaded on first access.
+		 * \param pPath The path of the file to be mapped.
+		 * \param pOutFile A MappedFile struct which holds the view and its handles.
+		 * \return True if mapped successfully; otherwise false.
+		 */
+		static bool TryMap(const char* pPath, MappedFile& pOutFile);
+
+		/**
+		 * \brief Unmaps the view and closes the handles of a mapped file.
+		 * \param pFile A MappedFile struct filled by TryMap.
+		 */
+		static void Unmap(MappedFile& pFile);
 	};
 }
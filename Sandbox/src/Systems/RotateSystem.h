@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Owl/ECS/Ecs.h"
+#include "Owl/ECS/System.h"
 #include "Owl/ECS/World.h"
 #include "Owl/ECS/Components/TransformComponent.h"
 